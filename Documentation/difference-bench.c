@@ -0,0 +1,200 @@
+/**
+ * @file difference-bench.c
+ * @brief Mesure des noyaux de comparaison de lignes (difference.c).
+ *
+ * Simule le travail du renderer : à chaque trame, quelques cases du
+ * plateau changent (tête, queue, pomme), puis chaque ligne est comparée
+ * à l'image affichée et les cases signalées par le masque sont recopiées
+ * dans l'image. Chaque noyau disponible est mesuré sur la même suite de
+ * trames, et ses masques sont vérifiés contre ceux du noyau scalaire.
+ *
+ * @details
+ * Compilation : gcc -O2 difference-bench.c difference.c -o difference-bench
+ *
+ * Usage : difference-bench [-t trames] [-c cases modifiées par trame] [-d LxH]
+ *
+ * Sans -d, les plateaux 80x40 et 1000x1000 sont mesurés.
+ *
+ * @author
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <stdint.h>
+
+#include "difference.h"
+
+/*****************************************************
+*DEFINITIONS CONSANTES/ VARIABLES GLOBALES/ FONCTIONS*
+*****************************************************/
+
+const long TRAMESDEFAUT = 2000; /** Nombre de trames mesurées par noyau. */
+const int MODIFIEESDEFAUT = 4; /** Cases modifiées par trame (tête, anneau, queue, pomme). */
+
+/** @brief Résultat de la mesure d'un noyau. */
+typedef struct {
+    double nsParTrame; /** Durée moyenne d'une trame. */
+    long casesVisitees; /** Cases signalées par les masques sur toutes les trames. */
+    uint64_t empreinte; /** Empreinte des masques, pour comparer les noyaux. */
+} Mesure;
+
+void mesurerPlateau(int largeur, int hauteur, long trames, int modifiees);
+Mesure mesurerNoyau(int largeur, int hauteur, long trames, int modifiees);
+double maintenant();
+
+/*****************************************************
+*                  PROGRAMME PRINCIPAL               *
+*****************************************************/
+
+/**
+ * @brief Lit les options et mesure chaque noyau sur les plateaux demandés.
+ * @param argc Nombre d'arguments.
+ * @param argv Arguments.
+ * @return EXIT_SUCCESS, ou EXIT_FAILURE si un noyau diverge du noyau scalaire.
+ */
+int main(int argc, char *argv[]) {
+    long trames = TRAMESDEFAUT;
+    int modifiees = MODIFIEESDEFAUT;
+    int largeur = 0, hauteur = 0;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:c:d:")) != -1) {
+        switch (option) {
+            case 't':
+                trames = atol(optarg);
+                break;
+            case 'c':
+                modifiees = atoi(optarg);
+                break;
+            case 'd':
+                if (sscanf(optarg, "%dx%d", &largeur, &hauteur) != 2 || largeur < 1 || hauteur < 1) {
+                    fprintf(stderr, "Dimensions invalides : %s (attendu LxH)\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-t trames] [-c cases modifiées] [-d LxH]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (trames < 1 || modifiees < 0) {
+        fprintf(stderr, "Nombre de trames ou de cases modifiées invalide\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Meilleur noyau disponible : %s\n", nomNoyauDifference(noyauDifferenceDisponible()));
+    if (largeur > 0) {
+        mesurerPlateau(largeur, hauteur, trames, modifiees);
+    } else {
+        mesurerPlateau(80, 40, trames, modifiees);
+        mesurerPlateau(1000, 1000, trames / 10 > 0 ? trames / 10 : 1, modifiees);
+    }
+    return EXIT_SUCCESS;
+}
+
+/*****************************************************
+*               FONCTIONS/PROCEDURES                *
+*****************************************************/
+
+/**
+ * @brief Mesure tous les noyaux disponibles sur un plateau et affiche le bilan.
+ *
+ * Quitte le programme si les masques d'un noyau diffèrent de ceux du noyau scalaire.
+ * @param largeur Largeur du plateau.
+ * @param hauteur Hauteur du plateau.
+ * @param trames Nombre de trames.
+ * @param modifiees Cases modifiées par trame.
+ */
+void mesurerPlateau(int largeur, int hauteur, long trames, int modifiees) {
+    Mesure reference = {0, 0, 0};
+
+    printf("Plateau %dx%d, %ld trames, %d cases modifiées par trame\n",
+        largeur, hauteur, trames, modifiees);
+    for (NoyauDifference noyau = DIFFSCALAIRE; noyau <= noyauDifferenceDisponible(); noyau++) {
+        choisirNoyauDifference(noyau);
+        Mesure mesure = mesurerNoyau(largeur, hauteur, trames, modifiees);
+        if (noyau == DIFFSCALAIRE) {
+            reference = mesure;
+        } else if (mesure.empreinte != reference.empreinte || mesure.casesVisitees != reference.casesVisitees) {
+            fprintf(stderr, "Le noyau %s diverge du noyau scalaire\n", nomNoyauDifference(noyau));
+            exit(EXIT_FAILURE);
+        }
+        printf("  %-8s : %10.0f ns/trame  (x%.1f)\n", nomNoyauDifference(noyau),
+            mesure.nsParTrame, reference.nsParTrame / mesure.nsParTrame);
+    }
+}
+
+/**
+ * @brief Joue la suite de trames avec le noyau courant.
+ *
+ * La suite de cases modifiées est la même pour tous les noyaux (graine fixe).
+ * @param largeur Largeur du plateau.
+ * @param hauteur Hauteur du plateau.
+ * @param trames Nombre de trames.
+ * @param modifiees Cases modifiées par trame.
+ * @return La durée moyenne d'une trame et l'empreinte des masques.
+ */
+Mesure mesurerNoyau(int largeur, int hauteur, long trames, int modifiees) {
+    size_t taille = (size_t)largeur * hauteur;
+    char *plateau = malloc(taille);
+    char *image = malloc(taille);
+    uint64_t *masque = malloc(MOTSMASQUE(largeur) * sizeof(uint64_t));
+    Mesure mesure = {0, 0, 0};
+    uint64_t graine = 0x9E3779B97F4A7C15u;
+    double total = 0;
+
+    if (plateau == NULL || image == NULL || masque == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memset(plateau, ' ', taille);
+    memset(image, ' ', taille);
+
+    for (long t = 0; t < trames; t++) {
+        /** quelques cases changent entre deux trames, comme en jeu */
+        for (int k = 0; k < modifiees; k++) {
+            graine = graine * 6364136223846793005u + 1442695040888963407u;
+            size_t position = (size_t)((graine >> 33) % taille);
+            plateau[position] = (plateau[position] == ' ') ? 'X' : ' ';
+        }
+
+        double debut = maintenant();
+        for (int i = 0; i < hauteur; i++) {
+            const char *ligne = &plateau[(size_t)i * largeur];
+            char *vue = &image[(size_t)i * largeur];
+            if (!differencesLigne(ligne, vue, largeur, masque)) {
+                continue;
+            }
+            for (int j = caseModifieeSuivante(masque, largeur, 0); j < largeur;
+                 j = caseModifieeSuivante(masque, largeur, j + 1)) {
+                vue[j] = ligne[j];
+                mesure.casesVisitees++;
+                mesure.empreinte = mesure.empreinte * 31 + (uint64_t)i * largeur + j;
+            }
+        }
+        total += maintenant() - debut;
+    }
+    mesure.nsParTrame = total * 1e9 / trames;
+
+    free(plateau);
+    free(image);
+    free(masque);
+    return mesure;
+}
+
+/**
+ * @brief Horloge monotone.
+ * @return Le temps courant en secondes.
+ */
+double maintenant() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
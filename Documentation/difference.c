@@ -0,0 +1,257 @@
+/**
+ * @file difference.c
+ * @brief Détection des cases modifiées entre deux images, ligne par ligne.
+ *
+ * Voir difference.h.
+ *
+ * @author
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#include <stddef.h>
+
+#include "difference.h"
+
+/** SSE2 fait partie du jeu d'instructions de base en x86-64 ; AVX2 est
+ * compilé à part (attribut target) et choisi à l'exécution */
+#if defined(__x86_64__)
+#define DIFFX86
+#include <immintrin.h>
+#endif
+
+/*****************************************************
+*                NOYAUX DE COMPARAISON               *
+*****************************************************/
+
+/**
+ * @brief Noyau scalaire : compare les cases une à une.
+ * @param ligne Ligne du plateau.
+ * @param image Même ligne de l'image affichée.
+ * @param n Nombre de cases de la ligne.
+ * @param masque Reçoit MOTSMASQUE(n) mots, un bit à 1 par case modifiée.
+ * @return true si au moins une case diffère.
+ */
+static bool differencesScalaire(const char *ligne, const char *image, int n, uint64_t *masque) {
+    uint64_t cumul = 0;
+
+    for (int k = 0; k < MOTSMASQUE(n); k++) {
+        int debut = k * 64;
+        int fin = (debut + 64 < n) ? debut + 64 : n;
+        uint64_t mot = 0;
+        for (int j = debut; j < fin; j++) {
+            mot |= (uint64_t)(ligne[j] != image[j]) << (j - debut);
+        }
+        masque[k] = mot;
+        cumul |= mot;
+    }
+    return cumul != 0;
+}
+
+#ifdef DIFFX86
+/**
+ * @brief Calcule le dernier mot, incomplet, du masque d'une ligne.
+ *
+ * Les blocs entiers de 16 cases sont comparés en SSE2, le reste case par case.
+ * Toujours développée en ligne : dans le noyau AVX2, elle est alors codée en
+ * VEX et évite la pénalité de transition entre instructions SSE et AVX.
+ * @param ligne Début des cases restantes de la ligne du plateau.
+ * @param image Début des cases restantes de l'image.
+ * @param reste Nombre de cases restantes (moins de 64).
+ * @return Le mot du masque.
+ */
+__attribute__((always_inline))
+static inline uint64_t motFinalSSE2(const char *ligne, const char *image, int reste) {
+    uint64_t mot = 0;
+    int j = 0;
+
+    for (; j + 16 <= reste; j += 16) {
+        __m128i egaux = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(ligne + j)),
+                                       _mm_loadu_si128((const __m128i *)(image + j)));
+        mot |= (uint64_t)(uint16_t)~_mm_movemask_epi8(egaux) << j;
+    }
+    for (; j < reste; j++) {
+        mot |= (uint64_t)(ligne[j] != image[j]) << j;
+    }
+    return mot;
+}
+
+/**
+ * @brief Noyau SSE2 : compare 16 cases à la fois.
+ *
+ * Chaque mot du masque est assemblé à partir de quatre comparaisons de
+ * 16 octets ; le dernier mot d'une ligne incomplète passe par motFinalSSE2.
+ * @param ligne Ligne du plateau.
+ * @param image Même ligne de l'image affichée.
+ * @param n Nombre de cases de la ligne.
+ * @param masque Reçoit MOTSMASQUE(n) mots, un bit à 1 par case modifiée.
+ * @return true si au moins une case diffère.
+ */
+static bool differencesSSE2(const char *ligne, const char *image, int n, uint64_t *masque) {
+    uint64_t cumul = 0;
+    int complets = n / 64;
+
+    for (int k = 0; k < complets; k++) {
+        uint64_t mot = 0;
+        for (int q = 0; q < 4; q++) {
+            const char *a = ligne + k * 64 + q * 16;
+            const char *b = image + k * 64 + q * 16;
+            __m128i egaux = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a),
+                                           _mm_loadu_si128((const __m128i *)b));
+            uint64_t differents = (uint16_t)~_mm_movemask_epi8(egaux);
+            mot |= differents << (q * 16);
+        }
+        masque[k] = mot;
+        cumul |= mot;
+    }
+    if (complets * 64 < n) {
+        masque[complets] = motFinalSSE2(ligne + complets * 64, image + complets * 64, n - complets * 64);
+        cumul |= masque[complets];
+    }
+    return cumul != 0;
+}
+
+/**
+ * @brief Noyau AVX2 : compare 32 cases à la fois.
+ * @param ligne Ligne du plateau.
+ * @param image Même ligne de l'image affichée.
+ * @param n Nombre de cases de la ligne.
+ * @param masque Reçoit MOTSMASQUE(n) mots, un bit à 1 par case modifiée.
+ * @return true si au moins une case diffère.
+ */
+__attribute__((target("avx2")))
+static bool differencesAVX2(const char *ligne, const char *image, int n, uint64_t *masque) {
+    uint64_t cumul = 0;
+    int complets = n / 64;
+
+    for (int k = 0; k < complets; k++) {
+        const char *a = ligne + k * 64;
+        const char *b = image + k * 64;
+        __m256i egauxBas = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)a),
+                                             _mm256_loadu_si256((const __m256i *)b));
+        __m256i egauxHaut = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(a + 32)),
+                                              _mm256_loadu_si256((const __m256i *)(b + 32)));
+        uint64_t mot = ~(((uint64_t)(uint32_t)_mm256_movemask_epi8(egauxHaut) << 32) |
+                         (uint32_t)_mm256_movemask_epi8(egauxBas));
+        masque[k] = mot;
+        cumul |= mot;
+    }
+    if (complets * 64 < n) {
+        masque[complets] = motFinalSSE2(ligne + complets * 64, image + complets * 64, n - complets * 64);
+        cumul |= masque[complets];
+    }
+    return cumul != 0;
+}
+#endif
+
+/*****************************************************
+*               FONCTIONS/PROCEDURES                *
+*****************************************************/
+
+/** Noyau utilisé par differencesLigne, choisi au premier appel. */
+static bool (*noyauCourant)(const char *, const char *, int, uint64_t *) = NULL;
+static NoyauDifference noyauChoisi = DIFFSCALAIRE;
+
+/**
+ * @brief Compare une ligne du plateau à la ligne correspondante de l'image.
+ * @param ligne Ligne du plateau.
+ * @param image Même ligne de l'image affichée.
+ * @param n Nombre de cases de la ligne.
+ * @param masque Reçoit MOTSMASQUE(n) mots, un bit à 1 par case modifiée.
+ * @return true si au moins une case diffère.
+ */
+bool differencesLigne(const char *ligne, const char *image, int n, uint64_t *masque) {
+    if (noyauCourant == NULL) {
+        choisirNoyauDifference(noyauDifferenceDisponible());
+    }
+    return noyauCourant(ligne, image, n, masque);
+}
+
+/**
+ * @brief Cherche la prochaine case modifiée d'un masque.
+ * @param masque Masque rempli par differencesLigne.
+ * @param n Nombre de cases couvertes par le masque.
+ * @param depuis Première case à examiner.
+ * @return L'indice de la première case modifiée à partir de depuis, ou n s'il n'y en a plus.
+ */
+int caseModifieeSuivante(const uint64_t *masque, int n, int depuis) {
+    int k = depuis / 64;
+
+    if (depuis >= n) {
+        return n;
+    }
+    /** ignore les bits des cases déjà traitées dans le premier mot */
+    uint64_t mot = masque[k] & (~UINT64_C(0) << (depuis % 64));
+    while (mot == 0) {
+        if (++k >= MOTSMASQUE(n)) {
+            return n;
+        }
+        mot = masque[k];
+    }
+    int j = k * 64 + __builtin_ctzll(mot);
+    return (j < n) ? j : n;
+}
+
+/**
+ * @brief Meilleur noyau pris en charge par le processeur.
+ * @return DIFFAVX2, DIFFSSE2 ou DIFFSCALAIRE.
+ */
+NoyauDifference noyauDifferenceDisponible() {
+#ifdef DIFFX86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return DIFFAVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return DIFFSSE2;
+    }
+#endif
+    return DIFFSCALAIRE;
+}
+
+/**
+ * @brief Impose le noyau utilisé par differencesLigne.
+ * @param noyau Noyau voulu.
+ * @return false si le processeur ne le prend pas en charge (le noyau courant est conservé).
+ */
+bool choisirNoyauDifference(NoyauDifference noyau) {
+    if (noyau > noyauDifferenceDisponible()) {
+        return false;
+    }
+    noyauChoisi = noyau;
+#ifdef DIFFX86
+    if (noyau == DIFFAVX2) {
+        noyauCourant = differencesAVX2;
+        return true;
+    }
+    if (noyau == DIFFSSE2) {
+        noyauCourant = differencesSSE2;
+        return true;
+    }
+#endif
+    noyauCourant = differencesScalaire;
+    return true;
+}
+
+/**
+ * @brief Noyau utilisé par differencesLigne.
+ * @return Le noyau courant (le meilleur disponible si aucun n'a été imposé).
+ */
+NoyauDifference noyauDifferenceCourant() {
+    if (noyauCourant == NULL) {
+        choisirNoyauDifference(noyauDifferenceDisponible());
+    }
+    return noyauChoisi;
+}
+
+/**
+ * @brief Nom d'un noyau, pour les bilans.
+ * @param noyau Noyau.
+ * @return Son nom en clair.
+ */
+const char *nomNoyauDifference(NoyauDifference noyau) {
+    if (noyau == DIFFAVX2) return "AVX2";
+    if (noyau == DIFFSSE2) return "SSE2";
+    return "scalaire";
+}
@@ -0,0 +1,48 @@
+/**
+ * @file difference.h
+ * @brief Détection des cases modifiées entre deux images, ligne par ligne.
+ *
+ * Compare une ligne du plateau à la même ligne de l'image déjà affichée et
+ * produit un masque de bits (un bit par case, 64 cases par mot) des cases
+ * qui diffèrent. Le renderer ne visite ensuite que ces cases.
+ *
+ * @details
+ * Trois noyaux sont disponibles : scalaire (toutes machines), SSE2
+ * (16 cases par comparaison) et AVX2 (32 cases par comparaison). Le
+ * meilleur noyau pris en charge par le processeur est choisi à
+ * l'exécution ; choisirNoyauDifference permet d'en imposer un autre.
+ *
+ * Compilation : ajouter difference.c à la ligne de commande du programme
+ * (voir programme.c et difference-bench.c).
+ *
+ * @author
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#ifndef DIFFERENCE_H
+#define DIFFERENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Nombre de mots de 64 bits d'un masque couvrant n cases. */
+#define MOTSMASQUE(n) (((n) + 63) / 64)
+
+/** @brief Noyaux de comparaison disponibles. */
+typedef enum {
+    DIFFSCALAIRE,
+    DIFFSSE2,
+    DIFFAVX2
+} NoyauDifference;
+
+/** Déclaration des fonctions */
+bool differencesLigne(const char *ligne, const char *image, int n, uint64_t *masque);
+int caseModifieeSuivante(const uint64_t *masque, int n, int depuis);
+NoyauDifference noyauDifferenceDisponible();
+bool choisirNoyauDifference(NoyauDifference noyau);
+NoyauDifference noyauDifferenceCourant();
+const char *nomNoyauDifference(NoyauDifference noyau);
+
+#endif
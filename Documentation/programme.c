@@ -17,6 +17,21 @@
  * - Le jeu se termine lorsque le serpent heurte un mur, un obstacle, ou lui-même.
  * - Les bordures et des pavés (obstacles fixes) rendent le jeu plus difficile.
  *
+ * Les règles du jeu sont dans la bibliothèque libsnake (snake.h, snake.c) ;
+ * ce fichier ne contient que la partie terminal : clavier, affichage et
+ * temporisation. Compilation : gcc programme.c snake.c difference.c -o programme
+ * (ou avec libsnake.a, voir snake.h).
+ *
+ * La boucle principale est une boucle d'événements epoll (Linux) : elle ne
+ * se réveille que pour une échéance de pas (timerfd), une touche (stdin)
+ * ou un signal (signalfd), et ne consomme aucun temps processeur entre-temps.
+ *
+ * Si le plateau est plus grand que le terminal, seule une fenêtre qui suit
+ * la tête du serpent est affichée ; elle s'adapte à la taille du terminal
+ * à chaque SIGWINCH. Avec -u, chaque caractère montre deux cases
+ * superposées (demi-blocs Unicode en couleurs) : un plateau 80x80 tient
+ * dans un terminal de 40 lignes.
+ *
  * @author 
  * Arthur CHAUVEL
  * 
@@ -38,6 +53,19 @@
 #include <time.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+#include <sys/ioctl.h>
+
+#include "snake.h"
+#include "difference.h"
 
 /*****************************************************
 *DEFINITIONS CONSANTES/ VARIABLES GLOBALES/ FONCTIONS*
@@ -48,60 +76,280 @@
  * @defgroup Constante du jeu
  * 
  */
-/** Largeur maximale du plateau de jeu. */
-#define LARGEURMAX 80
-/** Hauteur maximale du plateau de jeu. */
-#define HAUTEURMAX 40
-/** Taille maximale que le serpent peut atteindre. */
-#define MAXTAILLESERPENT 100 
-
-const int COORDMIN = 1; /** Coordonnée minimale utilisée sur le plateau. */
-const int TAILLESERPENT = 10; /** Taille initiale du serpent. */
-const int NBREPAVE = 4; /** Nombre de pavés d'obstacles à placer. */
-const int TAILLEPAVE = 5; /** Taille d'un pavé d'obstacle. */
-const int TEMPORISATION = 200000; /** Temps de pause entre deux déplacements */
-const int NBREPOMMESFINJEU = 10; /** Nombre de pommes à manger pour gagner. */
-const int COORDXDEPART = 40; /** Coordonnée X de départ du serpent. */
-const int COORDYDEPART = 20; 
-const int STARTSAFEZONEX = 22; /** Début de la zone de sécurité en X. */
-const int ENDSAFEZONEX = 43; /** Fin de la zone de sécurité en X. */
-const int STARTSAFEZONEY = 12; /** Début de la zone de sécurité en Y. */
-const int ENDSAFEZONEY = 23; /** Fin de la zone de sécurité en Y. */
-const int AUGMENTATIONVITESSE = 15000; /** augmentation de la vitesse */
-const char TETE = 'O'; /** Caractère représentant la tête du serpent. */
-const char CORPS = 'X'; /** Caractère représentant le corps du serpent. */
-const char POMME = '6'; /** Caractère représentant une pomme. */
-const char ARRET = 'a'; /** Caractère permettant d'arrêter le jeu. */
-const char DROITE = 'd'; /** Direction : droite. */
-const char GAUCHE = 'q'; /** Direction : gauche. */
-const char HAUT = 'z'; /** Direction : haut. */
-const char BAS = 's'; /** Direction : bas. */
-const char VIDE = ' '; /** Caractère représentant une case vide. */
-const char CARBORDURE = '#'; /** Caractère représentant une bordure ou un obstacle. */
-
-/** @typedef Plateau_de_jeu
-* @brief Définition du plateau de jeu comme une matrice de caractères.
-*/
-char plateau[HAUTEURMAX +1][LARGEURMAX +1];
-
-
-/** @brief Variables globales modifiables en cours de jeu. */
-int tailleSerpent = TAILLESERPENT;
-int temporisation = TEMPORISATION;
-int posX_pomme = -1, posY_pomme = -1;
+/** Capacité du tampon d'assemblage d'une trame (en octets). */
+#define TAILLETAMPON 16384
+/** Taille maximale d'un script de touches pour le mode turbo. */
+#define MAXSCRIPT 65536
+/** Nombre maximal de touches lues en un seul appel à read. */
+#define MAXTOUCHES 64
+/** Nombre maximal d'événements traités par réveil de la boucle. */
+#define MAXEVENEMENTS 4
+/** Capacité de la file des changements de direction (puissance de 2). */
+#define TAILLEFILEDIRECTIONS 8
+/** Nombre maximal de pas rattrapés d'affilée après un retard. */
+#define MAXRATTRAPAGE 4
+/** Largeur d'une classe de l'histogramme des latences, en nanosecondes (100 µs). */
+#define LARGEURCLASSE 100000
+/** Nombre de classes de l'histogramme (jusqu'à 1 s, la dernière reçoit le reste). */
+#define NBCLASSES 10000
+
+/** @brief Fenêtre d'affichage : partie du plateau visible dans le terminal.
+ *
+ * Le plateau peut être plus grand que le terminal : seule la fenêtre est
+ * dessinée, et elle suit la tête du serpent. L'image mémorisée est en
+ * coordonnées d'écran (une case par case de la fenêtre) : un défilement
+ * ne réécrit que les cases de l'écran qui changent réellement. En
+ * demi-blocs, chaque ligne du terminal montre deux lignes de la fenêtre :
+ * l'image a alors deux lignes par ligne du terminal.
+ */
+typedef struct {
+    int largeur; /** Largeur de la fenêtre (terminal et plateau bornent). */
+    int hauteur; /** Hauteur de la fenêtre, en cases du plateau. */
+    int lignes; /** Lignes du terminal occupées (hauteur, ou sa moitié arrondie au-dessus en demi-blocs). */
+    int origineX; /** Colonne du plateau affichée en haut à gauche. */
+    int origineY; /** Ligne du plateau affichée en haut à gauche. */
+    int colonnesTerminal; /** Largeur du terminal, pour suivre le curseur en fin de ligne. */
+    char *image; /** Dernière image envoyée, largeur x hauteur cases (largeur x 2 lignes en demi-blocs). */
+    uint64_t *masque; /** Cases modifiées de la ligne en cours, MOTSMASQUE(largeur) mots (deux masques en demi-blocs). */
+    char *ligneVide; /** Ligne de cases vides, sous la dernière ligne du plateau si la hauteur est impaire. */
+    bool valide; /** L'image correspond à l'écran ; faux au départ et après SIGWINCH. */
+} Fenetre;
+
+Fenetre fenetre = {0, 0, 0, 0, 0, 0, NULL, NULL, NULL, false};
+
+/** @brief Position du curseur du terminal, suivie pour choisir le
+ * déplacement le plus court vers la prochaine case à écrire.
+ */
+typedef struct {
+    int x; /** Colonne (à partir de 1). */
+    int y; /** Ligne (à partir de 1). */
+    bool connue; /** Faux tant qu'aucun positionnement absolu n'a suivi un effacement. */
+} Curseur;
+
+Curseur curseur = {0, 0, false};
+
+/** @brief Le terminal accepte la séquence REP (ESC [ n b), qui répète
+ * n fois le dernier caractère affiché. Décidé au démarrage d'après TERM,
+ * désactivable par -R.
+ */
+bool repetitionPermise = false;
+
+/** Préfixes de TERM des terminaux connus pour accepter REP. */
+const char *TERMINAUXREP[] = {"xterm", "vte", "foot", "alacritty", "kitty", "wezterm"};
+
+/** Écart jusqu'auquel les cases déjà affichées sont réécrites plutôt que
+ * sautées par une séquence CUF (qui coûte au moins 3 octets). */
+#define MAXREECRITURE 3
+
+/** @brief Affichage en demi-blocs Unicode (-u) : chaque caractère du
+ * terminal montre deux cases superposées, par la couleur de son avant-plan
+ * et de son arrière-plan (▀, ▄ ou espace). Un plateau 80x80 tient alors
+ * dans 40 lignes.
+ */
+bool demiBlocs = false;
+
+/** Demi-blocs haut et bas, en UTF-8. */
+const char DEMIHAUT[] = "\xe2\x96\x80";
+const char DEMIBAS[] = "\xe2\x96\x84";
+/** Couleur SGR « par défaut » (39 ou 49), celle des cases vides. */
+#define COULEURDEFAUT 9
+
+/** @brief Couleurs SGR courantes du terminal, pour n'envoyer que les
+ * changements. Connues après chaque effacement, qui commence par SGR 0.
+ */
+typedef struct {
+    int avantPlan; /** Chiffre de la couleur d'avant-plan (3x). */
+    int arrierePlan; /** Chiffre de la couleur d'arrière-plan (4x). */
+} Couleurs;
+
+Couleurs couleurs = {COULEURDEFAUT, COULEURDEFAUT};
+
+/** @brief Contrôle de la liste des cases modifiées (-V) : chaque trame
+ * dessinée d'après la liste est suivie d'une comparaison complète, qui
+ * compte les cases que la liste aurait oubliées.
+ */
+typedef struct {
+    bool active; /** Contrôle demandé par -V. */
+    long trames; /** Trames dessinées d'après la liste puis contrôlées. */
+    long oublis; /** Cases trouvées différentes par la comparaison complète. */
+} Verification;
+
+Verification verification = {false, 0, 0};
+
+/** Représentation décimale des nombres de 00 à 99, deux chiffres par nombre. */
+const char PAIRESCHIFFRES[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/** @brief Tampon de sortie : toutes les séquences d'une trame y sont
+ * assemblées puis envoyées au terminal en un seul appel à write.
+ */
+typedef struct {
+    char octets[TAILLETAMPON]; /** Contenu en attente d'écriture. */
+    int longueur; /** Nombre d'octets en attente. */
+    long octetsTrame; /** Octets écrits pendant la trame en cours. */
+    int appelsTrame; /** Appels système write pendant la trame en cours. */
+    long octetsTotal; /** Octets écrits depuis le début de la partie. */
+    long appelsTotal; /** Appels système write depuis le début de la partie. */
+    long nbTrames; /** Nombre de trames terminées. */
+} TamponSortie;
+
+TamponSortie tampon;
+
+/** @brief Session de terminal du jeu.
+ *
+ * Pendant la partie, le terminal est en mode brut (non canonique, sans écho,
+ * lecture immédiate) et affiche l'écran alternatif, curseur masqué et
+ * retour à la ligne automatique désactivé : le jeu ne touche pas à
+ * l'historique du terminal. Tout est restauré à la sortie du programme,
+ * à la réception d'un signal ou en cas de plantage. Une suspension (Ctrl-Z)
+ * ferme la session et la reprise (SIGCONT) la rouvre.
+ */
+typedef struct {
+    struct termios origine; /** Réglages termios d'avant la session. */
+    struct termios brut; /** Réglages termios de la session, réappliqués à la reprise. */
+    bool modeBrut; /** Le mode brut a été activé (entrée = terminal). */
+    bool active; /** La session est ouverte. */
+    bool suspendue; /** La session a été fermée par SIGTSTP et doit être rouverte à la reprise. */
+    bool gestionnaires; /** atexit et gestionnaires de signaux déjà installés. */
+} SessionTerminal;
+
+SessionTerminal session;
+
+/** Mis à 1 par la reprise de session : l'écran ne correspond plus à l'image
+ * du renderer, la prochaine trame redessine toute la fenêtre.
+ */
+volatile sig_atomic_t ecranPerdu = 0;
+
+/** Séquences d'entrée et de sortie de session : écran alternatif,
+ * curseur masqué, retour à la ligne automatique désactivé ; à la sortie,
+ * les couleurs (demi-blocs) sont aussi remises à zéro.
+ */
+const char ENTREESESSION[] = "\033[?1049h\033[?25l\033[?7l";
+const char SORTIESESSION[] = "\033[0m\033[?7h\033[?25h\033[?1049l";
+
+/** @brief Cadence de la simulation, réglée sur des échéances absolues.
+ *
+ * Chaque pas a une échéance sur l'horloge monotone ; la suivante est
+ * calculée à partir de la précédente et non de la fin du travail, si bien
+ * que la durée de l'affichage ne décale pas la vitesse du serpent.
+ */
+typedef struct {
+    struct timespec echeance; /** Échéance du prochain pas. */
+    long pas; /** Nombre de pas simulés. */
+    long depassements; /** Pas joués en retard de plus d'une période. */
+} Cadence;
+
+/** @brief Descripteurs de la boucle d'événements. */
+typedef struct {
+    int epoll; /** Instance epoll surveillant les trois sources. */
+    int minuterie; /** timerfd armé sur l'échéance du prochain pas. */
+    int signaux; /** signalfd recevant SIGINT, SIGTERM, SIGWINCH, SIGTSTP et SIGCONT. */
+} Evenements;
+
+/** @brief File bornée des changements de direction en attente.
+ *
+ * Chaque touche valide y est ajoutée dans l'ordre et un seul changement
+ * est appliqué par pas : un « haut puis droite » rapide donne bien deux
+ * virages sur deux pas. Le demi-tour est jugé par rapport à la dernière
+ * direction mise en file, pas à la direction courante.
+ * Un seul producteur et un seul consommateur : les indices atomiques
+ * suffisent, sans verrou, si la lecture du clavier passe dans un thread.
+ */
+typedef struct {
+    char directions[TAILLEFILEDIRECTIONS]; /** Directions en attente. */
+    uint64_t arrivees[TAILLEFILEDIRECTIONS]; /** Instant de lecture de chaque touche (ns). */
+    _Atomic unsigned int debut; /** Prochain élément à défiler (consommateur). */
+    _Atomic unsigned int fin; /** Prochaine place libre (producteur). */
+    char derniere; /** Dernière direction acceptée (producteur). */
+    int profondeurMax; /** Plus grand nombre de directions en attente observé. */
+    long pertes; /** Directions perdues car la file était pleine. */
+    long demiTours; /** Directions refusées car opposées à la précédente. */
+} FileDirections;
+
+/** @brief Histogramme de latences à classes de largeur fixe. */
+typedef struct {
+    long compte[NBCLASSES]; /** Nombre de mesures par classe. */
+    long total; /** Nombre total de mesures. */
+    uint64_t max; /** Plus grande latence mesurée (ns). */
+} Histogramme;
+
+/** @brief Mesure en cours d'une touche, de sa lecture jusqu'à son affichage. */
+typedef struct {
+    uint64_t arrivee; /** Lecture de la touche (ns). */
+    uint64_t consommation; /** Prise en compte par progresser (ns). */
+} MesureEntree;
+
+/** @brief Latences touche → pas et touche → écran, et journal optionnel. */
+Histogramme latenceConsommation;
+Histogramme latenceAffichage;
+FILE *journalLatences = NULL;
+
+/** @brief Réglages du mode turbo (simulation sans temporisation). */
+typedef struct {
+    char script[MAXSCRIPT]; /** Touches jouées à raison d'une par pas ; vide = robot glouton. */
+    int longueurScript; /** Nombre de touches du script. */
+    long decimation; /** Affiche un pas sur decimation (0 : aucun affichage). */
+    long nbParties; /** Nombre de parties enchaînées. */
+    long maxPas; /** Nombre de pas au-delà duquel une partie est abandonnée. */
+} ReglagesTurbo;
+
+uint64_t graine;
+int largeurPlateau = LARGEURDEFAUT; /** Largeur du plateau choisie par -d. */
+int hauteurPlateau = HAUTEURDEFAUT; /** Hauteur du plateau choisie par -d. */
 
 /** D&claration des fonctions */
 void afficher(int x, int y, char c);
 void effacer(int x, int y);
-void initPlateau();
-void ajouterPomme();
-void placerPaves();
-void dessinerPlateau(int lesX[], int lesY[]);
-void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *pommeMangee);
+uint64_t graineAleatoire();
+void dessinerPlateau(EtatJeu *etat);
+void dessinerModifications(const EtatJeu *etat);
+int comparerFenetre(const EtatJeu *etat);
+bool bilanVerification();
+void dimensionnerFenetre(Fenetre *vue, const Plateau *plateau);
+int suivreTete(int origine, int tete, int taille, int taillePlateau);
 void gotoXY(int x, int y);
-void disableEcho();
-void enableEcho();
-int kbhit();
+int nbChiffres(int n);
+int ecrireEntier(char *dest, int n);
+int sequenceRelative(char *dest, int n, char commande);
+int coutRelatif(int n);
+void afficherPlage(int x, int y, char c, int n);
+void afficherDemiBlocs(int x, int y, char haut, char bas, int n);
+void changerCouleurs(int avantPlan, int arrierePlan);
+int couleurCase(char c);
+void repeterCaractere(const char *caractere, int longueur, int n);
+char glyphe(char contenu);
+const char *ligneFenetre(const EtatJeu *etat, int y);
+int celluleEcran(const char *haut, const char *bas, int x);
+void afficherCellules(int x, int ligne, int cellule, int n);
+bool terminalRepete();
+void tamponAjouter(const char *octets, int n);
+void tamponVider();
+void terminerTrame();
+void ouvrirSession();
+void fermerSession();
+void interrompre(int signal);
+void suspendre(int signal);
+void reprendre(int signal);
+void reprendreSession();
+int lireTouches(char touches[], int max);
+int jouerTurbo(const ReglagesTurbo *reglages);
+bool chargerScript(ReglagesTurbo *reglages, const char *chemin);
+void demarrerCadence(Cadence *cadence, long periode);
+bool echeanceAtteinte(const Cadence *cadence);
+void programmerPasSuivant(Cadence *cadence, long periode);
+void initFileDirections(FileDirections *file, char direction);
+bool enfilerDirection(FileDirections *file, char direction, uint64_t arrivee);
+bool defilerDirection(FileDirections *file, char *direction, uint64_t *arrivee);
+uint64_t instantNs();
+void enregistrerLatence(Histogramme *histogramme, uint64_t duree);
+double percentileMs(const Histogramme *histogramme, double p);
+void afficherLatences(const char *nom, const Histogramme *histogramme);
+void ouvrirEvenements(Evenements *evenements);
+void armerMinuterie(const Evenements *evenements, const Cadence *cadence);
+void fermerEvenements(Evenements *evenements);
 
 /*****************************************************
 *               PROGRAMME PRINCIPAL                  *
@@ -118,71 +366,240 @@ int kbhit();
  * et les conditions de fin de jeu. Met à jour le plateau et le serpent 
  * à chaque itération.
  *
+ * Options :
+ * - -g graine : rejouer une partie à l'identique ;
+ * - -l fichier : journal des latences des touches ;
+ * - -d LxH : taille du plateau, de 10x10 à 4096x4096 (80x40 par défaut) ;
+ *   sur les plus petits plateaux, il n'y a pas de pavés ;
+ * - -R : n'utilise pas la séquence de répétition REP, même si TERM l'annonce ;
+ * - -u : affichage en demi-blocs Unicode, deux cases par caractère ;
+ * - -V : contrôle chaque trame dessinée d'après la liste des cases modifiées
+ *   par une comparaison complète (mise au point) ;
+ * - -t : mode turbo, sans temporisation, joué par un script (-s fichier)
+ *   ou par le robot glouton (-b, par défaut), avec affichage d'un pas sur N
+ *   (-r N, aucun par défaut), sur -n parties d'au plus -m pas.
+ *
  * @return Retourne EXIT_SUCCESS après l'arrêt du jeu.
  */
-int main() {
+int main(int argc, char *argv[]) {
 
     // Déclaration des variables
-    int lesX[MAXTAILLESERPENT] = {40, 39, 38, 37, 36, 35, 34, 33, 32, 31};
-    int lesY[MAXTAILLESERPENT] = {20, 20, 20, 20, 20, 20, 20, 20, 20, 20};
+    EtatJeu *etat;
     char direction = DROITE;
-    bool collision = false;
-    bool pommeMangee = false;
+    char touches[MAXTOUCHES];
+    ResultatPas resultat = {false, false, false, false};
+    Cadence cadence = {{0, 0}, 0, 0};
+    Evenements evenements;
+    struct epoll_event prets[MAXEVENEMENTS];
+    FileDirections file;
+    MesureEntree mesures[MAXRATTRAPAGE];
+    int nbMesures = 0;
     bool forfait = false;
-    int pommesMangees = 0;
+    bool interrompu = false;
+    bool turbo = false;
+    static ReglagesTurbo reglages = {"", 0, 0, 1, 1000000};
+    int option;
 
-    //Appel des fonctions pour l'affichage du plateau, des pavés et de la première pomme 
-    initPlateau();
-    placerPaves();
-    ajouterPomme();
-    dessinerPlateau(lesX, lesY);
-
-    disableEcho();
-
-    // Boucle principale 
-    while (!collision && pommesMangees < NBREPOMMESFINJEU) {
-        if (kbhit()) {
-            char touche = getchar();
-            if ((touche == DROITE && direction != GAUCHE) ||
-                (touche == GAUCHE && direction != DROITE) ||
-                (touche == HAUT && direction != BAS) ||
-                (touche == BAS && direction != HAUT)) {
-                direction = touche;
+    // Lecture de la graine en ligne de commande, sinon tirée de l'entropie du système
+    graine = graineAleatoire();
+    repetitionPermise = terminalRepete();
+    while ((option = getopt(argc, argv, "g:l:d:RuVts:br:n:m:")) != -1) {
+        if (option == 't') {
+            turbo = true;
+        } else if (option == 's') {
+            if (!chargerScript(&reglages, optarg)) {
+                return EXIT_FAILURE;
             }
-            if (touche == ARRET){
-            forfait = true;
-            break;
+        } else if (option == 'b') {
+            reglages.longueurScript = 0;
+        } else if (option == 'r') {
+            reglages.decimation = atol(optarg);
+        } else if (option == 'n') {
+            reglages.nbParties = atol(optarg);
+        } else if (option == 'm') {
+            reglages.maxPas = atol(optarg);
+        } else if (option == 'd') {
+            if (sscanf(optarg, "%dx%d", &largeurPlateau, &hauteurPlateau) != 2) {
+                fprintf(stderr, "Taille de plateau invalide : %s\n", optarg);
+                return EXIT_FAILURE;
             }
+        } else if (option == 'R') {
+            repetitionPermise = false;
+        } else if (option == 'u') {
+            demiBlocs = true;
+        } else if (option == 'V') {
+            verification.active = true;
+        } else if (option == 'g') {
+            graine = strtoull(optarg, NULL, 10);
+        } else if (option == 'l') {
+            journalLatences = fopen(optarg, "w");
+            if (journalLatences == NULL) {
+                perror(optarg);
+                return EXIT_FAILURE;
+            }
+            fprintf(journalLatences, "arrivee_ns;consommation_ns;affichage_ns\n");
+        } else {
+            fprintf(stderr, "Usage : %s [-g graine] [-l journal des latences] [-d LxH] [-R] [-u] [-V]\n"
+                "        %s -t [-s script | -b] [-r N] [-n parties] [-m pas max] [-g graine] [-d LxH] [-R] [-u] [-V]\n",
+                argv[0], argv[0]);
+            return EXIT_FAILURE;
         }
+    }
+    if (turbo) {
+        return jouerTurbo(&reglages);
+    }
 
-        progresser(lesX, lesY, direction, &collision, &pommeMangee);
-        // gestion des modification lorqu'une pomme est mangée
-        if (pommeMangee) {
-            pommesMangees++;
-            temporisation = temporisation - AUGMENTATIONVITESSE;
-            tailleSerpent++;
-            ajouterPomme();
+    etat = creerEtatJeu(largeurPlateau, hauteurPlateau);
+    if (etat == NULL) {
+        fprintf(stderr, "Plateau %dx%d impossible (de %d à %d cases de côté)\n",
+            largeurPlateau, hauteurPlateau, TAILLEMIN, TAILLEMAX);
+        return EXIT_FAILURE;
+    }
+
+    //Appel des fonctions pour l'affichage du plateau, des pavés et de la première pomme 
+    ouvrirSession();
+    initEtatJeu(etat, graine, 0);
+    dessinerPlateau(etat);
+
+    initFileDirections(&file, direction);
+    ouvrirEvenements(&evenements);
+    demarrerCadence(&cadence, etat->temporisation);
+    armerMinuterie(&evenements, &cadence);
+
+    // Boucle principale : attend une touche, une échéance ou un signal
+    while (!resultat.collision && !resultat.victoire && !resultat.memoireEpuisee && !forfait && !interrompu) {
+        int nbPrets = epoll_wait(evenements.epoll, prets, MAXEVENEMENTS, -1);
+        if (nbPrets < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int e = 0; e < nbPrets; e++) {
+            int fd = prets[e].data.fd;
+
+            if (fd == STDIN_FILENO) {
+                /** les touches sont mises en file dès leur arrivée, dans l'ordre */
+                int nbTouches = lireTouches(touches, MAXTOUCHES);
+                uint64_t arrivee = instantNs();
+                if (nbTouches == 0) {
+                    /** entrée prête mais vide : fin de fichier, on ne la surveille plus */
+                    epoll_ctl(evenements.epoll, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+                }
+                for (int k = 0; k < nbTouches && !forfait; k++) {
+                    char touche = touches[k];
+                    if (touche == DROITE || touche == GAUCHE || touche == HAUT || touche == BAS) {
+                        enfilerDirection(&file, touche, arrivee);
+                    }
+                    if (touche == ARRET){
+                    forfait = true;
+                    }
+                }
+            } else if (fd == evenements.signaux) {
+                struct signalfd_siginfo info;
+                if (read(evenements.signaux, &info, sizeof(info)) == sizeof(info)) {
+                    if (info.ssi_signo == SIGWINCH) {
+                        /** taille du terminal modifiée : fenêtre recalculée et tout redessiné */
+                        fenetre.valide = false;
+                        dessinerPlateau(etat);
+                    } else if (info.ssi_signo == SIGTSTP) {
+                        /** Ctrl-Z : terminal restauré, puis arrêt jusqu'à SIGCONT */
+                        suspendre(SIGTSTP);
+                    } else if (info.ssi_signo == SIGCONT) {
+                        /** reprise : l'écran a été utilisé entre-temps, tout est redessiné
+                         * et la cadence repart de maintenant plutôt que de rattraper la pause
+                         */
+                        reprendreSession();
+                        fenetre.valide = false;
+                        dessinerPlateau(etat);
+                        demarrerCadence(&cadence, etat->temporisation);
+                        armerMinuterie(&evenements, &cadence);
+                    } else {
+                        interrompu = true;
+                    }
+                }
+            } else if (fd == evenements.minuterie) {
+                uint64_t expirations;
+                if (read(evenements.minuterie, &expirations, sizeof(expirations)) < 0) {
+                    continue;
+                }
+                /** joue tous les pas dont l'échéance est passée, puis affiche une
+                 * seule fois : la simulation ne dépend pas du temps d'affichage
+                 */
+                int rattrapes = 0;
+                while (echeanceAtteinte(&cadence) && !resultat.collision && !resultat.victoire &&
+                       !resultat.memoireEpuisee) {
+                    uint64_t arrivee;
+                    if (defilerDirection(&file, &direction, &arrivee)) {
+                        mesures[nbMesures].arrivee = arrivee;
+                        mesures[nbMesures].consommation = instantNs();
+                        nbMesures++;
+                    }
+                    resultat = avancer(etat, direction);
+                    programmerPasSuivant(&cadence, etat->temporisation);
+                    if (++rattrapes > 1) {
+                        cadence.depassements++;
+                    }
+                    if (rattrapes == MAXRATTRAPAGE) {
+                        /** trop de retard : repart de maintenant plutôt que d'accélérer */
+                        demarrerCadence(&cadence, etat->temporisation);
+                    }
+                }
+                armerMinuterie(&evenements, &cadence);
+                dessinerPlateau(etat);
+
+                /** la trame contenant l'effet des touches vient d'être écrite */
+                uint64_t affichage = instantNs();
+                for (int k = 0; k < nbMesures; k++) {
+                    enregistrerLatence(&latenceConsommation, mesures[k].consommation - mesures[k].arrivee);
+                    enregistrerLatence(&latenceAffichage, affichage - mesures[k].arrivee);
+                    if (journalLatences != NULL) {
+                        fprintf(journalLatences, "%" PRIu64 ";%" PRIu64 ";%" PRIu64 "\n",
+                            mesures[k].arrivee, mesures[k].consommation, affichage);
+                    }
+                }
+                nbMesures = 0;
+            }
         }
-        dessinerPlateau(lesX, lesY);
-        usleep(temporisation);
     }
-    enableEcho();
+    fermerEvenements(&evenements);
+    fermerSession();
+    detruireEtatJeu(etat);
 
     // Phrase de fin de jeu en fonction de l'issue de la partie
-    if (collision) { //si collision 
-        system("clear");
+    if (resultat.collision) { //si collision 
         printf("Collision détectée. Vous avez perdu.\n");
     }
-    else if (pommesMangees == NBREPOMMESFINJEU) { // si victoire
-        system("clear");
+    else if (resultat.victoire) { // si victoire
         printf("Vous avez gagné. Félicitations !\n");
     } 
     else if (forfait){ // si appui sur la touche de fin
-        system("clear");
         printf("Vous avez déclaré forfait. Dommage !\n");
     }
+    else if (interrompu) { // si signal d'arrêt reçu
+        printf("Partie interrompue.\n");
+    }
+    else if (resultat.memoireEpuisee) { // si le serpent n'a pu grandir
+        printf("Mémoire insuffisante pour agrandir le serpent.\n");
+    }
 
-    return EXIT_SUCCESS;
+    // Coût moyen d'une trame en sortie
+    if (tampon.nbTrames > 0) {
+        printf("Trames : %ld, %.1f octets/trame, %.2f appels write/trame\n",
+            tampon.nbTrames, (double)tampon.octetsTotal / tampon.nbTrames,
+            (double)tampon.appelsTotal / tampon.nbTrames);
+    }
+    printf("Pas : %ld, dont %ld en retard\n", cadence.pas, cadence.depassements);
+    printf("File de directions : profondeur max %d, %ld perdues, %ld demi-tours refusés\n",
+        file.profondeurMax, file.pertes, file.demiTours);
+    afficherLatences("Latence touche -> pas", &latenceConsommation);
+    afficherLatences("Latence touche -> écran", &latenceAffichage);
+    if (journalLatences != NULL) {
+        fclose(journalLatences);
+    }
+    printf("Graine : %" PRIu64 "\n", graine);
+
+    return bilanVerification() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 /*****************************************************
@@ -204,7 +621,12 @@ void afficher(int x, int y, char c) {
      * puis écrire le caractère voulu à la bonne position
      */
     gotoXY(x, y);
-    printf("%c", c);
+    tamponAjouter(&c, 1);
+    /** le retour à la ligne automatique est désactivé : en dernière
+     * colonne, le curseur reste sur place */
+    if (x < fenetre.colonnesTerminal) {
+        curseur.x = x + 1;
+    }
 }
 
 /**
@@ -220,123 +642,575 @@ void effacer(int x, int y) {
 }
 
 /**
- * @brief Initialise le plateau avec les bordures et les issues.
+ * @brief Affiche n fois un même caractère à partir d'une position.
+ *
+ * Au-delà du premier caractère, la plage est écrite par la séquence REP
+ * lorsque le terminal l'accepte et qu'elle est plus courte.
+ * @param x Coordonnée en X du premier caractère.
+ * @param y Coordonnée en Y.
+ * @param c Caractère à afficher.
+ * @param n Longueur de la plage.
+ */
+void afficherPlage(int x, int y, char c, int n) {
+    int reste = n - 1;
+
+    afficher(x, y, c);
+    if (reste == 0) {
+        return;
+    }
+    if (repetitionPermise && coutRelatif(reste) < reste) {
+        char sequence[16];
+        tamponAjouter(sequence, sequenceRelative(sequence, reste, 'b'));
+    } else {
+        for (int k = 0; k < reste; k++) {
+            tamponAjouter(&c, 1);
+        }
+    }
+    /** sans retour à la ligne automatique, le curseur bute sur la dernière colonne */
+    curseur.x = (x + n <= fenetre.colonnesTerminal) ? x + n : fenetre.colonnesTerminal;
+}
+
+/**
+ * @brief Affiche n fois un même demi-bloc (deux cases superposées) à partir d'une position.
+ *
+ * Deux cases identiques donnent une espace de la couleur d'arrière-plan ;
+ * une case vide reste en couleur par défaut, si bien que seule l'une des
+ * deux couleurs est envoyée quand l'autre case est vide. Les couleurs ne
+ * sont envoyées que si elles changent.
+ * @param x Colonne du terminal du premier caractère.
+ * @param y Ligne du terminal.
+ * @param haut Glyphe de la case du haut.
+ * @param bas Glyphe de la case du bas.
+ * @param n Longueur de la plage.
  */
-void initPlateau() {
-    /** Double boucle for permettant de se déplacer sur la bordure du tableau 
-     * en largeur et en hauteur et afficher la bordure 
-     * sauf si le curseur est au milieu de la bordure
+void afficherDemiBlocs(int x, int y, char haut, char bas, int n) {
+    gotoXY(x, y);
+    if (haut == bas) {
+        changerCouleurs(-1, couleurCase(haut));
+        repeterCaractere(" ", 1, n);
+    } else if (haut == VIDE) {
+        changerCouleurs(couleurCase(bas), COULEURDEFAUT);
+        repeterCaractere(DEMIBAS, sizeof(DEMIBAS) - 1, n);
+    } else {
+        changerCouleurs(couleurCase(haut), couleurCase(bas));
+        repeterCaractere(DEMIHAUT, sizeof(DEMIHAUT) - 1, n);
+    }
+    curseur.x = (x + n <= fenetre.colonnesTerminal) ? x + n : fenetre.colonnesTerminal;
+}
+
+/**
+ * @brief Écrit n fois un caractère, par la séquence REP si elle est plus courte.
+ * @param caractere Octets du caractère (UTF-8).
+ * @param longueur Nombre d'octets du caractère.
+ * @param n Nombre de répétitions.
+ */
+void repeterCaractere(const char *caractere, int longueur, int n) {
+    tamponAjouter(caractere, longueur);
+    if (n > 1 && repetitionPermise && coutRelatif(n - 1) < (n - 1) * longueur) {
+        char sequence[16];
+        tamponAjouter(sequence, sequenceRelative(sequence, n - 1, 'b'));
+    } else {
+        for (int k = 1; k < n; k++) {
+            tamponAjouter(caractere, longueur);
+        }
+    }
+}
+
+/**
+ * @brief Envoie les couleurs SGR qui diffèrent des couleurs courantes.
+ * @param avantPlan Couleur d'avant-plan voulue, -1 si indifférente.
+ * @param arrierePlan Couleur d'arrière-plan voulue.
+ */
+void changerCouleurs(int avantPlan, int arrierePlan) {
+    bool changeAvant = avantPlan >= 0 && avantPlan != couleurs.avantPlan;
+    bool changeArriere = arrierePlan != couleurs.arrierePlan;
+    char sequence[8];
+    int n = 0;
+
+    if (!changeAvant && !changeArriere) {
+        return;
+    }
+    sequence[n++] = '\033';
+    sequence[n++] = '[';
+    if (changeAvant) {
+        sequence[n++] = '3';
+        sequence[n++] = (char)('0' + avantPlan);
+        couleurs.avantPlan = avantPlan;
+    }
+    if (changeAvant && changeArriere) {
+        sequence[n++] = ';';
+    }
+    if (changeArriere) {
+        sequence[n++] = '4';
+        sequence[n++] = (char)('0' + arrierePlan);
+        couleurs.arrierePlan = arrierePlan;
+    }
+    sequence[n++] = 'm';
+    tamponAjouter(sequence, n);
+}
+
+/**
+ * @brief Couleur SGR d'une case en demi-blocs.
+ * @param c Glyphe de la case.
+ * @return Le chiffre de la couleur (1 rouge, 2 vert, 3 jaune, 7 blanc, 9 par défaut).
+ */
+int couleurCase(char c) {
+    if (c == TETE) return 3;
+    if (c == CORPS) return 2;
+    if (c == POMME) return 1;
+    if (c == CARBORDURE) return 7;
+    return COULEURDEFAUT;
+}
+
+/**
+ * @brief Caractère affiché pour le contenu d'une case.
+ * @param contenu Contenu de la case du plateau.
+ * @return Le caractère à afficher (les issues s'affichent comme des cases vides).
+ */
+char glyphe(char contenu) {
+    return (contenu == ISSUE) ? VIDE : contenu;
+}
+
+/**
+ * @brief Dessine la partie visible du plateau avec le serpent et les obstacles.
+ *
+ * Le serpent est déjà inscrit dans le plateau par progresser.
+ * Le rendu est incrémental : seules les cases de la fenêtre modifiées depuis
+ * la trame précédente sont réécrites, via un déplacement du curseur. En
+ * régime normal, ces cases sont lues dans la liste tenue par libsnake et le
+ * coût d'une trame ne dépend que du nombre de changements ; après un
+ * effacement, un défilement de la fenêtre ou un débordement de la liste,
+ * toute la fenêtre est comparée à l'image précédente.
+ * @param etat État de la partie à afficher ; sa liste de cases modifiées est vidée.
+ */
+void dessinerPlateau(EtatJeu *etat) {
+    if (ecranPerdu) {
+        ecranPerdu = 0;
+        fenetre.valide = false;
+    }
+    bool listeUtilisable = fenetre.valide && !etat->modifiees.debordement;
+    int origineX = fenetre.origineX, origineY = fenetre.origineY;
+
+    /** à la première trame (ou après un redimensionnement), efface l'écran par
+     * séquence d'échappement : l'image mémorisée devient alors entièrement vide
      */
-    for (int i = 0; i < HAUTEURMAX; i++) {
-        for (int j = 0; j < LARGEURMAX; j++) {
-            if (i == 0 || i == HAUTEURMAX - 1) {
-                plateau[i][j] = (j == LARGEURMAX / 2) ? VIDE : CARBORDURE;
-            } else if (j == 0 || j == LARGEURMAX - 1) {
-                plateau[i][j] = (i == HAUTEURMAX / 2) ? VIDE : CARBORDURE;
-            } else {
-                plateau[i][j] = VIDE;
-            }
+    if (!fenetre.valide) {
+        dimensionnerFenetre(&fenetre, &etat->plateau);
+        if (demiBlocs) {
+            /** l'effacement prend la couleur d'arrière-plan courante */
+            tamponAjouter("\033[0m", 4);
+            couleurs.avantPlan = COULEURDEFAUT;
+            couleurs.arrierePlan = COULEURDEFAUT;
         }
+        tamponAjouter("\033[2J", 4);
+        curseur.connue = false;
+        memset(fenetre.image, VIDE, (size_t)fenetre.largeur * fenetre.lignes * (demiBlocs ? 2 : 1));
+        fenetre.valide = true;
     }
+    fenetre.origineX = suivreTete(fenetre.origineX, serpentX(etat, 0),
+        fenetre.largeur, etat->plateau.largeur);
+    fenetre.origineY = suivreTete(fenetre.origineY, serpentY(etat, 0),
+        fenetre.hauteur, etat->plateau.hauteur);
+    /** un défilement change tout l'écran, pas seulement les cases écrites */
+    listeUtilisable = listeUtilisable && fenetre.origineX == origineX && fenetre.origineY == origineY;
+
+    if (listeUtilisable) {
+        dessinerModifications(etat);
+        if (verification.active) {
+            verification.trames++;
+            verification.oublis += comparerFenetre(etat);
+        }
+    } else {
+        comparerFenetre(etat);
+    }
+    viderModifications(etat);
+    terminerTrame();
 }
 
 /**
- * @brief Place une pomme sur une case vide aléatoire.
+ * @brief Réécrit les cases de la liste des cases modifiées qui sont dans la fenêtre.
+ *
+ * Les cases sont converties en cellules de l'écran, triées dans l'ordre de
+ * lecture de l'écran et dédoublonnées (en demi-blocs, deux cases
+ * superposées donnent la même cellule) ; des cellules voisines identiques
+ * forment une plage, comme pour comparerFenetre, si bien que la trame
+ * envoyée est la même qu'avec une comparaison complète.
+ * @param etat État de la partie, dont la liste n'a pas débordé.
  */
-void ajouterPomme() {
-    srand(time(NULL));
-    while (plateau[posY_pomme][posX_pomme] != VIDE) {
-        /** génère aléatoirement une coordonnée X */
-        posX_pomme = rand() % (LARGEURMAX - 2) + 1; 
-        /** génère aléatoirment une coordonnées Y */
-        posY_pomme = rand() % (HAUTEURMAX - 2) + 1; 
+void dessinerModifications(const EtatJeu *etat) {
+    const CasesModifiees *modifiees = &etat->modifiees;
+    int pas = etat->plateau.pas;
+    int largeur = fenetre.largeur;
+    int casesParLigne = demiBlocs ? 2 : 1;
+    int cellules[CAPACITEMODIFIEES];
+    int nb = 0;
+
+    /** tri par insertion : quelques cases par trame */
+    for (int k = 0; k < modifiees->nb; k++) {
+        int x = modifiees->cases[k] % pas - fenetre.origineX;
+        int y = modifiees->cases[k] / pas - fenetre.origineY;
+        if (x < 0 || x >= largeur || y < 0 || y >= fenetre.hauteur) {
+            continue;
+        }
+        int rang = (y / casesParLigne) * largeur + x;
+        int m = nb++;
+        while (m > 0 && cellules[m - 1] > rang) {
+            cellules[m] = cellules[m - 1];
+            m--;
+        }
+        cellules[m] = rang;
+    }
+
+    for (int k = 0; k < nb; k++) {
+        int rang = cellules[k];
+        int x = rang % largeur;
+        int ligne = rang / largeur;
+        int y = ligne * casesParLigne;
+        const char *haut = ligneFenetre(etat, y);
+        const char *bas = demiBlocs ? ligneFenetre(etat, y + 1) : NULL;
+        char *imageHaut = &fenetre.image[y * largeur];
+        char *imageBas = demiBlocs ? imageHaut + largeur : NULL;
+        int cellule = celluleEcran(haut, bas, x);
+        if (cellule == celluleEcran(imageHaut, imageBas, x)) {
+            continue;
+        }
+        /** prolonge la plage sur les cellules suivantes de la liste, si elles
+         * sont contiguës sur la même ligne et à réécrire à l'identique
+         */
+        int n = 1;
+        while (k + 1 < nb && x + n < largeur) {
+            if (cellules[k + 1] == rang + n - 1) {
+                k++;
+            } else if (cellules[k + 1] == rang + n && celluleEcran(haut, bas, x + n) == cellule &&
+                       celluleEcran(imageHaut, imageBas, x + n) != cellule) {
+                k++;
+                n++;
+            } else {
+                break;
+            }
+        }
+        afficherCellules(x, ligne, cellule, n);
     }
-    /** place la pomme si les coordonnées sont valides */
-    plateau[posY_pomme][posX_pomme] = POMME;
 }
 
 /**
- * @brief Place des pavés d'obstacles sur le plateau 
- * en dehors de la zone de sécurité.
+ * @brief Compare toute la fenêtre à l'image précédente et réécrit les cellules qui diffèrent.
+ *
+ * La comparaison vectorielle (difference.c) saute les lignes inchangées et
+ * ne laisse à visiter que les cases signalées par le masque (en
+ * demi-blocs, l'union des masques des deux lignes superposées) ; les
+ * cellules différentes sont regroupées en plages horizontales identiques.
+ * Les issues diffèrent toujours de leur glyphe : la vérification par glyphe
+ * reste nécessaire.
+ * @param etat État de la partie à afficher.
+ * @return Le nombre de cellules réécrites.
  */
-void placerPaves() {
-    srand(time(NULL));
-    for (int k = 0; k < NBREPAVE; k++) {
-        int x, y;
-        do {
-            /** génère aléatoirement une coordonnée X */
-            x = rand() % (LARGEURMAX - 10) + 2; 
-            /** génère aléatoirement une coordonnées Y */
-            y = rand() % (HAUTEURMAX - 10) + 2;
-        } while (x > STARTSAFEZONEX && x < ENDSAFEZONEX && 
-                 y > STARTSAFEZONEY && y < ENDSAFEZONEY);
-        /** vérifie que le pavé ne va pas chevaucher le serpent */
-        
-        /** place le pavé si les coordonnées sont valide */
-        for (int i = 0; i < TAILLEPAVE; i++) {
-            for (int j = 0; j < TAILLEPAVE; j++) {
-                plateau[y + i][x + j] = CARBORDURE;
+int comparerFenetre(const EtatJeu *etat) {
+    int largeur = fenetre.largeur;
+    int mots = MOTSMASQUE(largeur);
+    uint64_t *masqueBas = fenetre.masque + mots;
+    int reecrites = 0;
+
+    for (int ligne = 0; ligne < fenetre.lignes; ligne++) {
+        int y = demiBlocs ? 2 * ligne : ligne;
+        const char *haut = ligneFenetre(etat, y);
+        const char *bas = demiBlocs ? ligneFenetre(etat, y + 1) : NULL;
+        char *imageHaut = &fenetre.image[y * largeur];
+        char *imageBas = demiBlocs ? imageHaut + largeur : NULL;
+        bool modifiee = differencesLigne(haut, imageHaut, largeur, fenetre.masque);
+        if (bas != NULL && differencesLigne(bas, imageBas, largeur, masqueBas)) {
+            for (int k = 0; k < mots; k++) {
+                fenetre.masque[k] |= masqueBas[k];
+            }
+            modifiee = true;
+        }
+        if (!modifiee) {
+            continue;
+        }
+        for (int j = caseModifieeSuivante(fenetre.masque, largeur, 0); j < largeur;
+             j = caseModifieeSuivante(fenetre.masque, largeur, j + 1)) {
+            int cellule = celluleEcran(haut, bas, j);
+            if (cellule != celluleEcran(imageHaut, imageBas, j)) {
+                int n = 1;
+                while (j + n < largeur && celluleEcran(haut, bas, j + n) == cellule &&
+                       celluleEcran(imageHaut, imageBas, j + n) != cellule) {
+                    n++;
+                }
+                afficherCellules(j, ligne, cellule, n);
+                reecrites += n;
+                j += n - 1;
             }
         }
     }
+    return reecrites;
 }
 
 /**
- * @brief Dessine le plateau entier avec le serpent et les obstacles.
- * @param lesX Tableau des coordonnées x du serpent.
- * @param lesY Tableau des coordonnées y du serpent.
+ * @brief Ligne de la fenêtre, lue dans le plateau.
+ * @param etat État de la partie.
+ * @param y Ligne de la fenêtre ; la ligne qui suit la dernière est une ligne vide.
+ * @return Les largeur cases de la ligne, à partir de la première colonne de la fenêtre.
  */
-void dessinerPlateau(int lesX[], int lesY[]) {
-    /** affiche le serpent dans le terminal */
-    for (int i = 0; i < tailleSerpent; i++) {
-        plateau[lesY[i]][lesX[i]] = (i == 0) ? TETE : CORPS;
+const char *ligneFenetre(const EtatJeu *etat, int y) {
+    if (y >= fenetre.hauteur) {
+        return fenetre.ligneVide;
     }
-    system("clear");
-    /** affiche le plateau déja initialisé dans le terminal de jeu */
-    for (int i = 0; i < HAUTEURMAX; i++) {
-        for (int j = 0; j < LARGEURMAX; j++) {
-            putchar(plateau[i][j]);
+    return lignePlateau(etat, fenetre.origineY + y) + fenetre.origineX;
+}
+
+/**
+ * @brief Contenu d'une cellule de l'écran : un glyphe, ou deux en demi-blocs.
+ *
+ * Sert aussi bien pour les lignes du plateau que pour celles de l'image.
+ * @param haut Ligne de la case affichée (du haut en demi-blocs).
+ * @param bas Ligne de la case du bas en demi-blocs, NULL sinon.
+ * @param x Colonne.
+ * @return Le glyphe de la case, ou glyphe du haut * 256 + glyphe du bas.
+ */
+int celluleEcran(const char *haut, const char *bas, int x) {
+    int cellule = (unsigned char)glyphe(haut[x]);
+    if (bas != NULL) {
+        cellule = (cellule << 8) | (unsigned char)glyphe(bas[x]);
+    }
+    return cellule;
+}
+
+/**
+ * @brief Affiche une plage de cellules identiques et la reporte dans l'image.
+ * @param x Colonne de la fenêtre de la première cellule (à partir de 0).
+ * @param ligne Ligne du terminal (à partir de 0).
+ * @param cellule Contenu des cellules (voir celluleEcran).
+ * @param n Longueur de la plage.
+ */
+void afficherCellules(int x, int ligne, int cellule, int n) {
+    if (demiBlocs) {
+        char *imageHaut = &fenetre.image[2 * ligne * fenetre.largeur];
+        afficherDemiBlocs(x + 1, ligne + 1, (char)(cellule >> 8), (char)cellule, n);
+        memset(&imageHaut[x], cellule >> 8, n);
+        memset(&imageHaut[fenetre.largeur + x], cellule & 0xff, n);
+    } else {
+        afficherPlage(x + 1, ligne + 1, (char)cellule, n);
+        memset(&fenetre.image[ligne * fenetre.largeur + x], cellule, n);
+    }
+}
+
+/**
+ * @brief Affiche le bilan du contrôle de la liste des cases modifiées (-V).
+ * @return false si la comparaison complète a trouvé des cases oubliées par la liste.
+ */
+bool bilanVerification() {
+    if (!verification.active) {
+        return true;
+    }
+    printf("Vérification : %ld trames contrôlées, %ld cases oubliées par la liste\n",
+        verification.trames, verification.oublis);
+    if (verification.oublis > 0) {
+        fprintf(stderr, "La liste des cases modifiées est incomplète\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Ajuste la fenêtre à la taille actuelle du terminal.
+ *
+ * La taille est lue par ioctl(TIOCGWINSZ) ; si la sortie n'est pas un
+ * terminal, la fenêtre couvre tout le plateau. En demi-blocs, chaque ligne
+ * du terminal montre deux lignes du plateau. L'image est réallouée à la
+ * nouvelle taille, ainsi que les masques des cases modifiées.
+ * @param vue Fenêtre à dimensionner.
+ * @param plateau Plateau affiché.
+ */
+void dimensionnerFenetre(Fenetre *vue, const Plateau *plateau) {
+    struct winsize taille;
+    int colonnes = plateau->largeur, lignes = plateau->hauteur;
+
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == 0 && taille.ws_col > 0 && taille.ws_row > 0) {
+        colonnes = taille.ws_col;
+        lignes = taille.ws_row;
+    }
+    vue->colonnesTerminal = colonnes;
+    vue->largeur = (colonnes < plateau->largeur) ? colonnes : plateau->largeur;
+    if (demiBlocs) {
+        vue->hauteur = (2 * lignes < plateau->hauteur) ? 2 * lignes : plateau->hauteur;
+        vue->lignes = (vue->hauteur + 1) / 2;
+    } else {
+        vue->hauteur = (lignes < plateau->hauteur) ? lignes : plateau->hauteur;
+        vue->lignes = vue->hauteur;
+    }
+    free(vue->image);
+    vue->image = malloc((size_t)vue->largeur * vue->lignes * (demiBlocs ? 2 : 1));
+    free(vue->masque);
+    vue->masque = malloc(2 * MOTSMASQUE(vue->largeur) * sizeof(uint64_t));
+    free(vue->ligneVide);
+    vue->ligneVide = malloc((size_t)vue->largeur);
+    if (vue->image == NULL || vue->masque == NULL || vue->ligneVide == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memset(vue->ligneVide, VIDE, (size_t)vue->largeur);
+}
+
+/**
+ * @brief Calcule l'origine de la fenêtre sur un axe pour suivre la tête.
+ *
+ * La fenêtre ne bouge pas tant que la tête reste à plus d'un quart de sa
+ * taille des bords ; sinon elle est recentrée sur la tête. Elle ne sort
+ * jamais du plateau.
+ * @param origine Origine actuelle de la fenêtre sur cet axe.
+ * @param tete Coordonnée de la tête sur cet axe.
+ * @param taille Taille de la fenêtre sur cet axe.
+ * @param taillePlateau Taille du plateau sur cet axe.
+ * @return La nouvelle origine.
+ */
+int suivreTete(int origine, int tete, int taille, int taillePlateau) {
+    int marge = taille / 4;
+
+    if (tete < origine + marge || tete >= origine + taille - marge) {
+        origine = tete - taille / 2;
+    }
+    if (origine > taillePlateau - taille) {
+        origine = taillePlateau - taille;
+    }
+    if (origine < 0) {
+        origine = 0;
+    }
+    return origine;
+}
+
+/**
+ * @brief Indique si le terminal décrit par TERM accepte la séquence REP.
+ * @return true si TERM commence par le nom d'un terminal connu pour l'accepter.
+ */
+bool terminalRepete() {
+    const char *terminal = getenv("TERM");
+
+    if (terminal == NULL) {
+        return false;
+    }
+    for (size_t k = 0; k < sizeof(TERMINAUXREP) / sizeof(TERMINAUXREP[0]); k++) {
+        if (strncmp(terminal, TERMINAUXREP[k], strlen(TERMINAUXREP[k])) == 0) {
+            return true;
         }
-        putchar('\n');
     }
+    return false;
 }
 
 /**
- * @brief Fait progresser le serpent d'une étape.
- * @param lesX Tableau des coordonnées X du serpent.
- * @param lesY Tableau des coordonnées Y du serpent.
- * @param direction Direction actuelle du serpent.
- * @param collision Indique si une collision a été détectée.
- * @param pommeMangee Indique si une pomme a été mangée.
+ * @brief Fournit une graine issue de l'entropie du système.
+ * @return Une graine lue dans /dev/urandom, ou dérivée de l'heure à défaut.
  */
-void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *pommeMangee) {
-    /** effacer le dernier segment du seprent
-     * pour monter qu'il avance
-     */
-    int X = lesX[tailleSerpent - 1];
-    int Y = lesY[tailleSerpent - 1];
-    plateau[Y][X] = VIDE;
+uint64_t graineAleatoire() {
+    uint64_t valeur = 0;
+    int fd = open("/dev/urandom", O_RDONLY);
+    if (fd < 0 || read(fd, &valeur, sizeof(valeur)) != sizeof(valeur)) {
+        valeur = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return valeur;
+}
+
+/**
+ * @brief Mode turbo : enchaîne des parties aussi vite que le processeur le permet.
+ *
+ * Utilise le même chemin que le jeu (avancer, progresser, ajouterPomme,
+ * dessinerPlateau) sans aucune attente. Les directions viennent d'un script
+ * ou du robot glouton ; l'affichage peut être désactivé ou limité à un pas
+ * sur N. Le débit obtenu est affiché à la fin.
+ * @param reglages Réglages du mode turbo.
+ * @return EXIT_SUCCESS, ou EXIT_FAILURE si le plateau ne peut être créé.
+ */
+int jouerTurbo(const ReglagesTurbo *reglages) {
+    EtatJeu *etat = creerEtatJeu(largeurPlateau, hauteurPlateau);
+    long pasTotal = 0, collisions = 0, victoires = 0, abandons = 0;
 
-    for (int i = tailleSerpent - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
+    if (etat == NULL) {
+        fprintf(stderr, "Plateau %dx%d impossible (de %d à %d cases de côté)\n",
+            largeurPlateau, hauteurPlateau, TAILLEMIN, TAILLEMAX);
+        return EXIT_FAILURE;
+    }
+    if (reglages->decimation > 0) {
+        ouvrirSession();
     }
-    /** change la coordonnée adéquate du seprent en fonction de la  direction*/
-    if (direction == DROITE) lesX[0]++;
-    if (direction == GAUCHE) lesX[0]--;
-    if (direction == HAUT) lesY[0]--;
-    if (direction == BAS) lesY[0]++;
+    uint64_t debut = instantNs();
+    for (long partie = 0; partie < reglages->nbParties; partie++) {
+        ResultatPas resultat = {false, false, false, false};
+        char direction = DROITE;
+        long pas = 0;
 
-    /** gestion de la réapparition du seprent lorsqu'il emprunte une issue */
-    if (lesX[0] == 0 && lesY[0] == HAUTEURMAX / 2) lesX[0] = LARGEURMAX - 2;
-    else if (lesX[0] == LARGEURMAX - 1 && lesY[0] == HAUTEURMAX / 2) lesX[0] = 1;
-    else if (lesY[0] == 0 && lesX[0] == LARGEURMAX / 2) lesY[0] = HAUTEURMAX - 2;
-    else if (lesY[0] == HAUTEURMAX - 1 && lesX[0] == LARGEURMAX / 2) lesY[0] = 1;
+        initEtatJeu(etat, graine + (uint64_t)partie, (uint64_t)partie);
+        while (!resultat.collision && !resultat.victoire && !resultat.memoireEpuisee &&
+               pas < reglages->maxPas) {
+            char choix = (reglages->longueurScript > 0)
+                ? reglages->script[pas % reglages->longueurScript]
+                : directionGlouton(etat, direction);
+            if ((choix == DROITE || choix == GAUCHE || choix == HAUT || choix == BAS) &&
+                choix != directionOpposee(direction)) {
+                direction = choix;
+            }
+            resultat = avancer(etat, direction);
+            pas++;
+            if (reglages->decimation > 0 && pas % reglages->decimation == 0) {
+                dessinerPlateau(etat);
+            }
+        }
+        pasTotal += pas;
+        if (resultat.memoireEpuisee) {
+            fermerSession();
+            fprintf(stderr, "Mémoire insuffisante pour agrandir le serpent\n");
+            detruireEtatJeu(etat);
+            return EXIT_FAILURE;
+        }
+        if (resultat.collision) collisions++;
+        else if (resultat.victoire) victoires++;
+        else abandons++;
+    }
+    double duree = (instantNs() - debut) / 1e9;
+    detruireEtatJeu(etat);
 
-    /** Gestion des collisions avec le plateau, les pavés et le corps du serpent */
-    *collision = plateau[lesY[0]][lesX[0]] == CARBORDURE || 
-        plateau[lesY[0]][lesX[0]] == CORPS;
-    *pommeMangee = (lesX[0] == posX_pomme && lesY[0] == posY_pomme);
+    fermerSession();
+    printf("Turbo : %ld pas en %.3f s, %.0f pas/seconde\n", pasTotal, duree, pasTotal / duree);
+    printf("Parties : %ld (%ld collisions, %ld victoires, %ld abandons)\n",
+        reglages->nbParties, collisions, victoires, abandons);
+    if (tampon.nbTrames > 0) {
+        printf("Trames : %ld, %.1f octets/trame\n",
+            tampon.nbTrames, (double)tampon.octetsTotal / tampon.nbTrames);
+    }
+    printf("Graine : %" PRIu64 "\n", graine);
+    return bilanVerification() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Charge un script de touches pour le mode turbo.
+ *
+ * Seules les touches de direction sont retenues ; elles sont jouées à raison
+ * d'une par pas, en boucle.
+ * @param reglages Réglages recevant le script.
+ * @param chemin Fichier contenant le script.
+ * @return true si au moins une touche a été chargée.
+ */
+bool chargerScript(ReglagesTurbo *reglages, const char *chemin) {
+    FILE *f = fopen(chemin, "r");
+    int c;
+
+    if (f == NULL) {
+        perror(chemin);
+        return false;
+    }
+    reglages->longueurScript = 0;
+    while ((c = fgetc(f)) != EOF && reglages->longueurScript < MAXSCRIPT) {
+        if (c == DROITE || c == GAUCHE || c == HAUT || c == BAS) {
+            reglages->script[reglages->longueurScript++] = (char)c;
+        }
+    }
+    fclose(f);
+    if (reglages->longueurScript == 0) {
+        fprintf(stderr, "%s : aucune touche de direction\n", chemin);
+        return false;
+    }
+    return true;
 }
 
 /*****************************************************
@@ -347,44 +1221,585 @@ void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *p
  * @defgroup Fonction et procédure "Boite noire"
  * 
  */
+/**
+ * @brief Place le curseur en (x, y) par la séquence la plus courte.
+ *
+ * Selon la position connue du curseur : aucun déplacement s'il y est déjà
+ * (case suivant la précédente), réécriture des cases déjà affichées pour un
+ * petit saut vers la droite, retour chariot vers la première colonne,
+ * déplacements relatifs (CUU/CUD, CUF/CUB, CHA) s'ils sont plus courts,
+ * sinon positionnement absolu (CUP).
+ * Les nombres sont convertis sans printf.
+ * @param x Colonne (à partir de 1).
+ * @param y Ligne (à partir de 1).
+ */
 void gotoXY(int x, int y) {
-    printf("\033[%d;%df", y, x);
+    char sequence[32];
+    int n = 0;
+
+    if (curseur.connue && curseur.x == x && curseur.y == y) {
+        return;
+    }
+    if (curseur.connue) {
+        int dx = x - curseur.x;
+        int dy = y - curseur.y;
+        int coutAbsolu = 4 + nbChiffres(y) + nbChiffres(x);
+        int coutVertical = (dy == 0) ? 0 : coutRelatif(abs(dy));
+        int coutHorizontal = 0;
+        char horizontal = 0;
+
+        if (dx > 0 && dx <= MAXREECRITURE && y <= fenetre.lignes && !demiBlocs) {
+            /** les cases sautées sont à l'écran telles que dans l'image
+             * (pas en demi-blocs : il faudrait aussi renvoyer leurs couleurs) */
+            coutHorizontal = dx;
+            horizontal = 'r';
+        } else if (x == 1 && dx != 0) {
+            /** retour chariot : un seul octet vers la première colonne */
+            coutHorizontal = 1;
+            horizontal = '\r';
+        } else if (dx != 0) {
+            coutHorizontal = coutRelatif(abs(dx));
+            horizontal = (dx > 0) ? 'C' : 'D';
+            if (3 + nbChiffres(x) < coutHorizontal) {
+                coutHorizontal = 3 + nbChiffres(x);
+                horizontal = 'G';
+            }
+        }
+        if (coutVertical + coutHorizontal < coutAbsolu) {
+            if (dy != 0) {
+                n += sequenceRelative(sequence + n, abs(dy), (dy > 0) ? 'B' : 'A');
+            }
+            if (horizontal == 'r') {
+                tamponAjouter(sequence, n);
+                tamponAjouter(&fenetre.image[(y - 1) * fenetre.largeur + curseur.x - 1], dx);
+                n = 0;
+            } else if (horizontal == '\r') {
+                sequence[n++] = '\r';
+            } else if (horizontal == 'G') {
+                n += sequenceRelative(sequence + n, x, 'G');
+            } else if (horizontal != 0) {
+                n += sequenceRelative(sequence + n, abs(dx), horizontal);
+            }
+            tamponAjouter(sequence, n);
+            curseur.x = x;
+            curseur.y = y;
+            return;
+        }
+    }
+    /** positionnement absolu : ESC [ y ; x H */
+    sequence[n++] = '\033';
+    sequence[n++] = '[';
+    n += ecrireEntier(sequence + n, y);
+    sequence[n++] = ';';
+    n += ecrireEntier(sequence + n, x);
+    sequence[n++] = 'H';
+    tamponAjouter(sequence, n);
+    curseur.x = x;
+    curseur.y = y;
+    curseur.connue = true;
 }
 
-void disableEcho() {
-    struct termios tty;
-    tcgetattr(STDIN_FILENO, &tty);
-    tty.c_lflag &= ~ECHO;
-    tcsetattr(STDIN_FILENO, TCSANOW, &tty);
+/**
+ * @brief Nombre de chiffres décimaux d'un entier positif.
+ * @param n Entier (de 0 à 99999).
+ * @return Le nombre de chiffres.
+ */
+int nbChiffres(int n) {
+    return 1 + (n >= 10) + (n >= 100) + (n >= 1000) + (n >= 10000);
 }
 
-void enableEcho() {
-    struct termios tty;
-    tcgetattr(STDIN_FILENO, &tty);
-    tty.c_lflag |= ECHO;
-    tcsetattr(STDIN_FILENO, TCSANOW, &tty);
+/**
+ * @brief Écrit un entier positif en décimal, deux chiffres à la fois.
+ * @param dest Destination (au moins 5 octets).
+ * @param n Entier (de 0 à 99999).
+ * @return Le nombre d'octets écrits.
+ */
+int ecrireEntier(char *dest, int n) {
+    int longueur = nbChiffres(n);
+    char *p = dest + longueur;
+
+    while (n >= 100) {
+        int paire = (n % 100) * 2;
+        n /= 100;
+        p -= 2;
+        p[0] = PAIRESCHIFFRES[paire];
+        p[1] = PAIRESCHIFFRES[paire + 1];
+    }
+    if (n >= 10) {
+        p -= 2;
+        p[0] = PAIRESCHIFFRES[n * 2];
+        p[1] = PAIRESCHIFFRES[n * 2 + 1];
+    } else {
+        *--p = (char)('0' + n);
+    }
+    return longueur;
 }
 
-int kbhit() {
-    struct termios oldt, newt;
-    int ch, oldf;
+/**
+ * @brief Écrit une séquence ESC [ n commande (n omis s'il vaut 1).
+ * @param dest Destination.
+ * @param n Paramètre de la séquence.
+ * @param commande Lettre finale (A, B, C, D, G, ou b pour REP).
+ * @return Le nombre d'octets écrits.
+ */
+int sequenceRelative(char *dest, int n, char commande) {
+    int longueur = 0;
+    dest[longueur++] = '\033';
+    dest[longueur++] = '[';
+    if (n != 1) {
+        longueur += ecrireEntier(dest + longueur, n);
+    }
+    dest[longueur++] = commande;
+    return longueur;
+}
 
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
+/**
+ * @brief Longueur d'une séquence ESC [ n commande (déplacement relatif ou REP).
+ * @param n Paramètre de la séquence (strictement positif).
+ * @return Le nombre d'octets de la séquence.
+ */
+int coutRelatif(int n) {
+    return (n == 1) ? 3 : 3 + nbChiffres(n);
+}
 
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+/**
+ * @brief Ajoute des octets au tampon de la trame en cours.
+ * @param octets Octets à ajouter.
+ * @param n Nombre d'octets.
+ */
+void tamponAjouter(const char *octets, int n) {
+    /** ne vide le tampon en cours de trame que s'il déborde */
+    if (tampon.longueur + n > TAILLETAMPON) {
+        tamponVider();
+    }
+    memcpy(tampon.octets + tampon.longueur, octets, n);
+    tampon.longueur += n;
+}
 
-    ch = getchar();
+/**
+ * @brief Écrit le contenu du tampon sur la sortie standard.
+ */
+void tamponVider() {
+    int ecrits = 0;
+    while (ecrits < tampon.longueur) {
+        ssize_t n = write(STDOUT_FILENO, tampon.octets + ecrits, tampon.longueur - ecrits);
+        tampon.appelsTrame++;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        ecrits += n;
+    }
+    tampon.octetsTrame += ecrits;
+    tampon.longueur = 0;
+}
 
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
+/**
+ * @brief Envoie la trame assemblée et met à jour les compteurs par trame.
+ */
+void terminerTrame() {
+    tamponVider();
+    tampon.octetsTotal += tampon.octetsTrame;
+    tampon.appelsTotal += tampon.appelsTrame;
+    tampon.nbTrames++;
+    tampon.octetsTrame = 0;
+    tampon.appelsTrame = 0;
+}
 
-    if (ch != EOF) {
-        ungetc(ch, stdin);
-        return 1;
+/**
+ * @brief Ouvre la session de terminal du jeu.
+ *
+ * Passe l'entrée en mode non canonique et sans écho, avec VMIN = VTIME = 0
+ * pour que read rende la main aussitôt (une seule fois, au démarrage). Le
+ * descripteur n'est pas mis en O_NONBLOCK : partagé avec la sortie quand
+ * les deux sont le même terminal, il rendrait aussi les écritures non
+ * bloquantes. Bascule ensuite sur l'écran alternatif, masque le curseur et
+ * désactive le retour à la ligne automatique. fermerSession est appelée à la
+ * sortie du programme et sur les signaux d'arrêt ou de plantage ; SIGTSTP
+ * et SIGCONT ferment puis rouvrent la session (suspendre, reprendre).
+ */
+void ouvrirSession() {
+    struct sigaction action;
+    const int signaux[] = {SIGHUP, SIGQUIT, SIGINT, SIGTERM, SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+    if (session.active) {
+        return;
+    }
+    session.modeBrut = isatty(STDIN_FILENO);
+    if (session.modeBrut) {
+        if (tcgetattr(STDIN_FILENO, &session.origine) == -1) {
+            perror("tcgetattr");
+            exit(EXIT_FAILURE);
+        }
+
+        session.brut = session.origine;
+        session.brut.c_lflag &= ~(ICANON | ECHO);
+        session.brut.c_cc[VMIN] = 0;
+        session.brut.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &session.brut) == -1) {
+            perror("tcsetattr");
+            exit(EXIT_FAILURE);
+        }
     }
-    return 0;
-} 
\ No newline at end of file
+    tamponAjouter(ENTREESESSION, sizeof(ENTREESESSION) - 1);
+    tamponVider();
+    /** l'entrée en session ne compte pas dans le coût des trames */
+    tampon.octetsTrame = 0;
+    tampon.appelsTrame = 0;
+    session.active = true;
+
+    if (session.gestionnaires) {
+        return;
+    }
+    session.gestionnaires = true;
+    atexit(fermerSession);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = interrompre;
+    sigemptyset(&action.sa_mask);
+    for (size_t k = 0; k < sizeof(signaux) / sizeof(signaux[0]); k++) {
+        sigaction(signaux[k], &action, NULL);
+    }
+    action.sa_handler = suspendre;
+    sigaction(SIGTSTP, &action, NULL);
+    action.sa_handler = reprendre;
+    sigaction(SIGCONT, &action, NULL);
+}
+
+/**
+ * @brief Rouvre la session fermée par une suspension.
+ *
+ * Relit les réglages du terminal (le shell a pu les changer pendant la
+ * pause), réapplique le mode brut et les séquences d'entrée, puis demande
+ * à la prochaine trame de tout redessiner. N'utilise que des appels sûrs
+ * dans un gestionnaire de signal.
+ */
+void reprendreSession() {
+    if (!session.suspendue) {
+        return;
+    }
+    session.suspendue = false;
+    if (session.modeBrut) {
+        tcgetattr(STDIN_FILENO, &session.origine);
+        tcsetattr(STDIN_FILENO, TCSANOW, &session.brut);
+    }
+    if (write(STDOUT_FILENO, ENTREESESSION, sizeof(ENTREESESSION) - 1) < 0) {
+        /** le terminal est peut-être fermé : la trame suivante échouera de même */
+    }
+    session.active = true;
+    ecranPerdu = 1;
+}
+
+/**
+ * @brief Ferme la session : terminal remis dans son état d'avant ouvrirSession.
+ *
+ * N'utilise que des appels sûrs dans un gestionnaire de signal.
+ */
+void fermerSession() {
+    if (session.active) {
+        session.active = false;
+        if (write(STDOUT_FILENO, SORTIESESSION, sizeof(SORTIESESSION) - 1) < 0) {
+            /** rien de plus à faire : le terminal est peut-être déjà fermé */
+        }
+        if (session.modeBrut) {
+            tcsetattr(STDIN_FILENO, TCSANOW, &session.origine);
+        }
+    }
+}
+
+/**
+ * @brief Restaure le terminal puis termine le programme avec le signal reçu.
+ * @param signal Numéro du signal reçu.
+ */
+void interrompre(int signal) {
+    fermerSession();
+    sigaction(signal, &(struct sigaction){ .sa_handler = SIG_DFL }, NULL);
+    raise(signal);
+}
+
+/**
+ * @brief Restaure le terminal puis arrête le programme jusqu'à SIGCONT.
+ *
+ * Gestionnaire de SIGTSTP, aussi appelée par la boucle d'événements qui
+ * reçoit le signal par signalfd. Le signal est relancé avec l'action par
+ * défaut, débloqué le temps de l'arrêt ; au retour, masque et gestionnaire
+ * sont rétablis. La session est rouverte par reprendre (ou par la boucle).
+ * @param signal Numéro du signal reçu (SIGTSTP).
+ */
+void suspendre(int signal) {
+    sigset_t masque, ancien;
+    int erreur = errno;
+
+    if (session.active) {
+        session.suspendue = true;
+        fermerSession();
+    }
+    sigaction(signal, &(struct sigaction){ .sa_handler = SIG_DFL }, NULL);
+    sigemptyset(&masque);
+    sigaddset(&masque, signal);
+    sigprocmask(SIG_UNBLOCK, &masque, &ancien);
+    raise(signal);
+    /** le programme est arrêté ici jusqu'à la reprise */
+    sigprocmask(SIG_SETMASK, &ancien, NULL);
+    sigaction(signal, &(struct sigaction){ .sa_handler = suspendre }, NULL);
+    errno = erreur;
+}
+
+/**
+ * @brief Gestionnaire de SIGCONT : rouvre la session après une suspension.
+ * @param signal Numéro du signal reçu (SIGCONT).
+ */
+void reprendre(int signal) {
+    int erreur = errno;
+
+    (void)signal;
+    reprendreSession();
+    errno = erreur;
+}
+
+/**
+ * @brief Lit en un seul appel toutes les touches en attente.
+ * @param touches Tableau recevant les touches lues.
+ * @param max Nombre maximal de touches à lire.
+ * @return Le nombre de touches lues (0 si aucune).
+ */
+int lireTouches(char touches[], int max) {
+    ssize_t n = read(STDIN_FILENO, touches, max);
+    return (n > 0) ? (int)n : 0;
+}
+
+/**
+ * @brief Fixe l'échéance du prochain pas à une période de l'instant présent.
+ * @param cadence Cadence à (re)démarrer.
+ * @param periode Période d'un pas, en microsecondes.
+ */
+void demarrerCadence(Cadence *cadence, long periode) {
+    clock_gettime(CLOCK_MONOTONIC, &cadence->echeance);
+    cadence->echeance.tv_nsec += periode * 1000;
+    while (cadence->echeance.tv_nsec >= 1000000000L) {
+        cadence->echeance.tv_nsec -= 1000000000L;
+        cadence->echeance.tv_sec++;
+    }
+}
+
+/**
+ * @brief Indique si l'échéance du prochain pas est passée.
+ * @param cadence Cadence de la partie.
+ * @return true si le pas doit être joué maintenant.
+ */
+bool echeanceAtteinte(const Cadence *cadence) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec > cadence->echeance.tv_sec ||
+        (t.tv_sec == cadence->echeance.tv_sec && t.tv_nsec >= cadence->echeance.tv_nsec);
+}
+
+/**
+ * @brief Compte un pas joué et repousse l'échéance d'une période.
+ *
+ * L'échéance suivante part de l'échéance précédente : aucune dérive ne
+ * s'accumule d'un pas à l'autre.
+ * @param cadence Cadence de la partie.
+ * @param periode Période du pas suivant, en microsecondes.
+ */
+void programmerPasSuivant(Cadence *cadence, long periode) {
+    cadence->pas++;
+    cadence->echeance.tv_nsec += periode * 1000;
+    while (cadence->echeance.tv_nsec >= 1000000000L) {
+        cadence->echeance.tv_nsec -= 1000000000L;
+        cadence->echeance.tv_sec++;
+    }
+}
+
+/**
+ * @brief Vide la file et fixe la direction de référence pour les demi-tours.
+ * @param file File à initialiser.
+ * @param direction Direction actuelle du serpent.
+ */
+void initFileDirections(FileDirections *file, char direction) {
+    atomic_init(&file->debut, 0);
+    atomic_init(&file->fin, 0);
+    file->derniere = direction;
+    file->profondeurMax = 0;
+    file->pertes = 0;
+    file->demiTours = 0;
+}
+
+/**
+ * @brief Ajoute un changement de direction en fin de file (côté producteur).
+ *
+ * Une direction identique à la précédente est ignorée, un demi-tour par
+ * rapport à la précédente est refusé, et une direction arrivant file
+ * pleine est perdue.
+ * @param file File des directions.
+ * @param direction Direction demandée.
+ * @param arrivee Instant de lecture de la touche, en nanosecondes.
+ * @return true si la direction a été mise en file.
+ */
+bool enfilerDirection(FileDirections *file, char direction, uint64_t arrivee) {
+    if (direction == file->derniere) {
+        return false;
+    }
+    if (direction == directionOpposee(file->derniere)) {
+        file->demiTours++;
+        return false;
+    }
+    unsigned int fin = atomic_load_explicit(&file->fin, memory_order_relaxed);
+    unsigned int debut = atomic_load_explicit(&file->debut, memory_order_acquire);
+    if (fin - debut == TAILLEFILEDIRECTIONS) {
+        file->pertes++;
+        return false;
+    }
+    file->directions[fin % TAILLEFILEDIRECTIONS] = direction;
+    file->arrivees[fin % TAILLEFILEDIRECTIONS] = arrivee;
+    atomic_store_explicit(&file->fin, fin + 1, memory_order_release);
+    file->derniere = direction;
+    if ((int)(fin + 1 - debut) > file->profondeurMax) {
+        file->profondeurMax = (int)(fin + 1 - debut);
+    }
+    return true;
+}
+
+/**
+ * @brief Retire le plus ancien changement de direction (côté consommateur).
+ * @param file File des directions.
+ * @param direction Reçoit la direction retirée ; inchangée si la file est vide.
+ * @param arrivee Reçoit l'instant de lecture de la touche correspondante.
+ * @return true si une direction a été retirée.
+ */
+bool defilerDirection(FileDirections *file, char *direction, uint64_t *arrivee) {
+    unsigned int debut = atomic_load_explicit(&file->debut, memory_order_relaxed);
+    unsigned int fin = atomic_load_explicit(&file->fin, memory_order_acquire);
+    if (debut == fin) {
+        return false;
+    }
+    *direction = file->directions[debut % TAILLEFILEDIRECTIONS];
+    *arrivee = file->arrivees[debut % TAILLEFILEDIRECTIONS];
+    atomic_store_explicit(&file->debut, debut + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Instant présent sur l'horloge monotone.
+ * @return Le temps écoulé depuis une origine fixe, en nanosecondes.
+ */
+uint64_t instantNs() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ULL + (uint64_t)t.tv_nsec;
+}
+
+/**
+ * @brief Ajoute une mesure à un histogramme de latences.
+ * @param histogramme Histogramme à compléter.
+ * @param duree Latence mesurée, en nanosecondes.
+ */
+void enregistrerLatence(Histogramme *histogramme, uint64_t duree) {
+    uint64_t classe = duree / LARGEURCLASSE;
+    histogramme->compte[(classe < NBCLASSES) ? classe : NBCLASSES - 1]++;
+    histogramme->total++;
+    if (duree > histogramme->max) {
+        histogramme->max = duree;
+    }
+}
+
+/**
+ * @brief Estime un percentile d'un histogramme (borne haute de la classe).
+ * @param histogramme Histogramme des latences.
+ * @param p Percentile voulu, entre 0 et 1.
+ * @return La latence correspondante, en millisecondes.
+ */
+double percentileMs(const Histogramme *histogramme, double p) {
+    long rang = (long)(p * histogramme->total);
+    long cumul = 0;
+    for (int k = 0; k < NBCLASSES; k++) {
+        cumul += histogramme->compte[k];
+        if (cumul > rang) {
+            double borne = (double)(k + 1) * LARGEURCLASSE;
+            return ((borne < histogramme->max) ? borne : histogramme->max) / 1e6;
+        }
+    }
+    return histogramme->max / 1e6;
+}
+
+/**
+ * @brief Affiche le résumé p50/p99/max d'un histogramme de latences.
+ * @param nom Libellé de la mesure.
+ * @param histogramme Histogramme des latences.
+ */
+void afficherLatences(const char *nom, const Histogramme *histogramme) {
+    if (histogramme->total == 0) {
+        return;
+    }
+    printf("%s : p50 %.1f ms, p99 %.1f ms, max %.1f ms (%ld touches)\n", nom,
+        percentileMs(histogramme, 0.50), percentileMs(histogramme, 0.99),
+        histogramme->max / 1e6, histogramme->total);
+}
+
+/**
+ * @brief Crée la boucle d'événements : minuterie, clavier et signaux.
+ *
+ * SIGINT, SIGTERM, SIGWINCH, SIGTSTP et SIGCONT sont bloqués puis reçus
+ * par un signalfd, ce qui permet de les traiter dans la boucle comme
+ * n'importe quel événement.
+ * @param evenements Descripteurs à initialiser.
+ */
+void ouvrirEvenements(Evenements *evenements) {
+    sigset_t masque;
+    struct epoll_event ev;
+
+    sigemptyset(&masque);
+    sigaddset(&masque, SIGINT);
+    sigaddset(&masque, SIGTERM);
+    sigaddset(&masque, SIGWINCH);
+    sigaddset(&masque, SIGTSTP);
+    sigaddset(&masque, SIGCONT);
+    sigprocmask(SIG_BLOCK, &masque, NULL);
+
+    evenements->epoll = epoll_create1(EPOLL_CLOEXEC);
+    evenements->minuterie = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    evenements->signaux = signalfd(-1, &masque, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (evenements->epoll < 0 || evenements->minuterie < 0 || evenements->signaux < 0) {
+        perror("epoll/timerfd/signalfd");
+        exit(EXIT_FAILURE);
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = STDIN_FILENO;
+    epoll_ctl(evenements->epoll, EPOLL_CTL_ADD, STDIN_FILENO, &ev);
+    ev.data.fd = evenements->minuterie;
+    epoll_ctl(evenements->epoll, EPOLL_CTL_ADD, evenements->minuterie, &ev);
+    ev.data.fd = evenements->signaux;
+    epoll_ctl(evenements->epoll, EPOLL_CTL_ADD, evenements->signaux, &ev);
+}
+
+/**
+ * @brief Arme la minuterie sur l'échéance absolue du prochain pas.
+ * @param evenements Descripteurs de la boucle.
+ * @param cadence Cadence de la partie.
+ */
+void armerMinuterie(const Evenements *evenements, const Cadence *cadence) {
+    struct itimerspec reglage;
+    memset(&reglage, 0, sizeof(reglage));
+    reglage.it_value = cadence->echeance;
+    timerfd_settime(evenements->minuterie, TFD_TIMER_ABSTIME, &reglage, NULL);
+}
+
+/**
+ * @brief Ferme les descripteurs de la boucle et débloque les signaux.
+ * @param evenements Descripteurs à fermer.
+ */
+void fermerEvenements(Evenements *evenements) {
+    sigset_t masque;
+
+    close(evenements->signaux);
+    close(evenements->minuterie);
+    close(evenements->epoll);
+    sigemptyset(&masque);
+    sigaddset(&masque, SIGINT);
+    sigaddset(&masque, SIGTERM);
+    sigaddset(&masque, SIGWINCH);
+    sigaddset(&masque, SIGTSTP);
+    sigaddset(&masque, SIGCONT);
+    sigprocmask(SIG_UNBLOCK, &masque, NULL);
+}
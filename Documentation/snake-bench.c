@@ -0,0 +1,388 @@
+/**
+ * @file snake-bench.c
+ * @brief Simulateur de parties en lot, sans affichage ni temporisation.
+ *
+ * Joue un grand nombre de parties avec libsnake sur tous les cœurs de la
+ * machine et mesure le débit obtenu (pas par seconde, parties par seconde)
+ * ainsi que la répartition des issues (collision, victoire, temps écoulé).
+ *
+ * @details
+ * Chaque thread possède son propre EtatJeu et une plage de parties à jouer.
+ * Un thread qui a fini sa plage vole la moitié de la plage restante d'un
+ * autre thread : la charge reste équilibrée même si les parties n'ont pas
+ * toutes la même durée.
+ *
+ * La partie numéro k utilise la graine (première graine + k) et le flux k.
+ *
+ * Compilation : gcc -O2 -pthread snake-bench.c snake.c -o snake-bench
+ *
+ * Usage : snake-bench [-n parties] [-g première graine] [-p aleatoire|script|glouton]
+ *                     [-s script] [-t threads] [-m pas maximum par partie] [-d LxH]
+ *                     [-G]
+ *
+ * -s choisit la politique script ; il ne peut être combiné à une autre
+ * politique donnée par -p.
+ *
+ * -G force le chemin générique de progresser même sur le plateau 80x40,
+ * pour mesurer le gain du noyau spécialisé.
+ *
+ * @author
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "snake.h"
+
+/*****************************************************
+*DEFINITIONS CONSANTES/ VARIABLES GLOBALES/ FONCTIONS*
+*****************************************************/
+
+/** Nombre maximal de threads de simulation. */
+#define MAXTHREADS 256
+
+const long MAXPASDEFAUT = 100000; /** Nombre de pas au-delà duquel une partie est abandonnée. */
+const char SCRIPTDEFAUT[] = "dddddzzzzzqqqqqsssss"; /** Script joué par la politique script. */
+
+/** @brief Politiques de jeu automatique disponibles. */
+typedef enum {
+    ALEATOIRE,
+    SCRIPT,
+    GLOUTON
+} Politique;
+
+/** @brief Données propres à un thread de simulation.
+ *
+ * La plage de parties restantes est codée dans un seul mot atomique
+ * (début sur les 32 bits de poids fort, fin sur les 32 bits de poids
+ * faible) : le propriétaire prend par le début, les voleurs par la fin.
+ * Alignée sur une ligne de cache pour éviter le faux partage.
+ */
+typedef struct {
+    _Alignas(64) _Atomic uint64_t plage;
+    pthread_t thread;
+    int numero; /** Rang du thread. */
+    long pas; /** Pas simulés par ce thread. */
+    long parties; /** Parties terminées par ce thread. */
+    long collisions; /** Parties perdues par collision. */
+    long victoires; /** Parties gagnées. */
+    long tempsEcoules; /** Parties arrêtées après le nombre maximal de pas. */
+    long vols; /** Plages volées à d'autres threads. */
+} Ouvrier;
+
+/** @brief Paramètres de la simulation, communs à tous les threads. */
+Ouvrier ouvriers[MAXTHREADS];
+int nbOuvriers;
+uint64_t premiereGraine = 1;
+Politique politique = GLOUTON;
+const char *script = SCRIPTDEFAUT;
+long maxPas;
+int largeurPlateau = LARGEURDEFAUT;
+int hauteurPlateau = HAUTEURDEFAUT;
+bool cheminGenerique = false; /** Désactive le noyau spécialisé 80x40 (-G). */
+
+/** Déclaration des fonctions */
+void *simuler(void *argument);
+long jouerPartie(EtatJeu *etat, uint64_t numero, ResultatPas *fin);
+bool prendrePartie(Ouvrier *ouvrier, uint32_t *numero);
+bool volerPlage(Ouvrier *voleur);
+char *filtrerScript(const char *brut);
+double maintenant();
+
+/*****************************************************
+*               PROGRAMME PRINCIPAL                  *
+*****************************************************/
+
+/**
+ * @brief Lance la simulation et affiche le bilan.
+ * @return EXIT_SUCCESS, ou EXIT_FAILURE si les options sont invalides ou si aucun thread n'a pu être créé.
+ */
+int main(int argc, char *argv[]) {
+    long nbParties = 10000;
+    bool scriptDonne = false;
+    int option;
+
+    nbOuvriers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    maxPas = MAXPASDEFAUT;
+    while ((option = getopt(argc, argv, "n:g:p:s:t:m:d:G")) != -1) {
+        switch (option) {
+            case 'n': nbParties = atol(optarg); break;
+            case 'g': premiereGraine = strtoull(optarg, NULL, 10); break;
+            case 's':
+                script = filtrerScript(optarg);
+                if (script == NULL) {
+                    fprintf(stderr, "%s : aucune touche de direction\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                scriptDonne = true;
+                politique = SCRIPT;
+                break;
+            case 't': nbOuvriers = atoi(optarg); break;
+            case 'm': maxPas = atol(optarg); break;
+            case 'G': cheminGenerique = true; break;
+            case 'd':
+                if (sscanf(optarg, "%dx%d", &largeurPlateau, &hauteurPlateau) != 2) {
+                    fprintf(stderr, "Taille de plateau invalide : %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'p':
+                if (strcmp(optarg, "aleatoire") == 0) politique = ALEATOIRE;
+                else if (strcmp(optarg, "script") == 0) politique = SCRIPT;
+                else if (strcmp(optarg, "glouton") == 0) politique = GLOUTON;
+                else {
+                    fprintf(stderr, "Politique inconnue : %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-n parties] [-g graine] [-p aleatoire|script|glouton]"
+                    " [-s script] [-t threads] [-m pas maximum] [-d LxH] [-G]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (scriptDonne && politique != SCRIPT) {
+        fprintf(stderr, "-s ne s'utilise qu'avec la politique script\n");
+        return EXIT_FAILURE;
+    }
+    if (nbOuvriers < 1) nbOuvriers = 1;
+    if (nbOuvriers > MAXTHREADS) nbOuvriers = MAXTHREADS;
+    if (nbParties < 0 || nbParties > UINT32_MAX || script[0] == '\0' ||
+        largeurPlateau < TAILLEMIN || largeurPlateau > TAILLEMAX ||
+        hauteurPlateau < TAILLEMIN || hauteurPlateau > TAILLEMAX) {
+        fprintf(stderr, "Options invalides\n");
+        return EXIT_FAILURE;
+    }
+
+    // Répartition initiale des parties en plages contiguës
+    for (int i = 0; i < nbOuvriers; i++) {
+        uint64_t debut = (uint64_t)nbParties * i / nbOuvriers;
+        uint64_t fin = (uint64_t)nbParties * (i + 1) / nbOuvriers;
+        atomic_init(&ouvriers[i].plage, (debut << 32) | fin);
+        ouvriers[i].numero = i;
+    }
+
+    /** si un thread ne peut être créé, on continue avec ceux déjà lancés :
+     * les plages des ouvriers sans thread leur sont volées */
+    double debut = maintenant();
+    int nbLances = 0;
+    while (nbLances < nbOuvriers) {
+        int erreur = pthread_create(&ouvriers[nbLances].thread, NULL, simuler, &ouvriers[nbLances]);
+        if (erreur != 0) {
+            fprintf(stderr, "pthread_create : %s (%d threads lancés sur %d)\n",
+                strerror(erreur), nbLances, nbOuvriers);
+            break;
+        }
+        nbLances++;
+    }
+    if (nbLances == 0) {
+        return EXIT_FAILURE;
+    }
+    long pas = 0, parties = 0, collisions = 0, victoires = 0, tempsEcoules = 0, vols = 0;
+    for (int i = 0; i < nbOuvriers; i++) {
+        if (i < nbLances) {
+            pthread_join(ouvriers[i].thread, NULL);
+        }
+        pas += ouvriers[i].pas;
+        parties += ouvriers[i].parties;
+        collisions += ouvriers[i].collisions;
+        victoires += ouvriers[i].victoires;
+        tempsEcoules += ouvriers[i].tempsEcoules;
+        vols += ouvriers[i].vols;
+    }
+    double duree = maintenant() - debut;
+
+    // Bilan
+    printf("Threads         : %d\n", nbLances);
+    printf("Plateau         : %dx%d (noyau %s)\n", largeurPlateau, hauteurPlateau,
+        (!cheminGenerique && largeurPlateau == LARGEURDEFAUT && hauteurPlateau == HAUTEURDEFAUT)
+        ? "spécialisé" : "générique");
+    printf("Parties         : %ld (graines %" PRIu64 " à %" PRIu64 ")\n",
+        parties, premiereGraine, premiereGraine + (uint64_t)nbParties - 1);
+    printf("Durée           : %.3f s\n", duree);
+    printf("Pas/seconde     : %.0f\n", pas / duree);
+    printf("Parties/seconde : %.0f\n", parties / duree);
+    printf("Collisions      : %ld (%.1f %%)\n", collisions, parties ? 100.0 * collisions / parties : 0.0);
+    printf("Victoires       : %ld (%.1f %%)\n", victoires, parties ? 100.0 * victoires / parties : 0.0);
+    printf("Temps écoulé    : %ld (%.1f %%)\n", tempsEcoules, parties ? 100.0 * tempsEcoules / parties : 0.0);
+    printf("Plages volées   : %ld\n", vols);
+
+    return EXIT_SUCCESS;
+}
+
+/*****************************************************
+*               FONCTIONS/PROCEDURES                *
+*****************************************************/
+
+/**
+ * @brief Corps d'un thread : joue des parties tant qu'il en reste à prendre ou à voler.
+ * @param argument Ouvrier associé au thread.
+ * @return NULL.
+ */
+void *simuler(void *argument) {
+    Ouvrier *ouvrier = argument;
+    EtatJeu *etat = creerEtatJeu(largeurPlateau, hauteurPlateau);
+    uint32_t numero;
+
+    if (etat == NULL) {
+        perror("creerEtatJeu");
+        exit(EXIT_FAILURE);
+    }
+    if (cheminGenerique) {
+        etat->noyauSpecialise = false;
+    }
+    do {
+        while (prendrePartie(ouvrier, &numero)) {
+            ResultatPas fin;
+            ouvrier->pas += jouerPartie(etat, numero, &fin);
+            if (fin.memoireEpuisee) {
+                fprintf(stderr, "Mémoire insuffisante pour agrandir le serpent\n");
+                exit(EXIT_FAILURE);
+            }
+            ouvrier->parties++;
+            if (fin.collision) ouvrier->collisions++;
+            else if (fin.victoire) ouvrier->victoires++;
+            else ouvrier->tempsEcoules++;
+        }
+    } while (volerPlage(ouvrier));
+    detruireEtatJeu(etat);
+    return NULL;
+}
+
+/**
+ * @brief Joue une partie complète avec la politique choisie.
+ * @param etat État réutilisé pour la partie.
+ * @param numero Numéro de la partie, qui détermine sa graine et son flux.
+ * @param fin Reçoit le résultat du dernier pas joué.
+ * @return Le nombre de pas joués.
+ */
+long jouerPartie(EtatJeu *etat, uint64_t numero, ResultatPas *fin) {
+    Generateur joueur;
+    char direction = DROITE;
+    size_t longueurScript = strlen(script);
+    long pas = 0;
+    ResultatPas resultat = {false, false, false, false};
+
+    initEtatJeu(etat, premiereGraine + numero, numero);
+    // Le joueur aléatoire tire dans un flux distinct de celui de la partie
+    initGenerateur(&joueur, premiereGraine + numero, numero | (UINT64_C(1) << 63));
+
+    while (!resultat.collision && !resultat.victoire && !resultat.memoireEpuisee && pas < maxPas) {
+        char choix;
+        if (politique == ALEATOIRE) {
+            choix = directionAleatoire(&joueur, direction);
+        } else if (politique == SCRIPT) {
+            choix = script[pas % longueurScript];
+        } else {
+            choix = directionGlouton(etat, direction);
+        }
+        if (choix != directionOpposee(direction)) {
+            direction = choix;
+        }
+        resultat = avancer(etat, direction);
+        pas++;
+    }
+    *fin = resultat;
+    return pas;
+}
+
+/**
+ * @brief Prend la prochaine partie de la plage d'un ouvrier (par le début).
+ * @param ouvrier Ouvrier propriétaire de la plage.
+ * @param numero Reçoit le numéro de la partie prise.
+ * @return true si une partie a été prise, false si la plage est vide.
+ */
+bool prendrePartie(Ouvrier *ouvrier, uint32_t *numero) {
+    uint64_t plage = atomic_load(&ouvrier->plage);
+    for (;;) {
+        uint32_t debut = (uint32_t)(plage >> 32);
+        uint32_t fin = (uint32_t)plage;
+        if (debut >= fin) {
+            return false;
+        }
+        if (atomic_compare_exchange_weak(&ouvrier->plage, &plage, ((uint64_t)(debut + 1) << 32) | fin)) {
+            *numero = debut;
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Vole la seconde moitié de la plage d'un autre ouvrier.
+ *
+ * Seul le voleur écrit dans sa propre plage, et uniquement lorsqu'elle
+ * est vide : les autres voleurs l'ignorent alors.
+ * @param voleur Ouvrier dont la plage est épuisée.
+ * @return true si une plage a été volée, false s'il ne reste plus rien.
+ */
+bool volerPlage(Ouvrier *voleur) {
+    for (int k = 1; k < nbOuvriers; k++) {
+        Ouvrier *victime = &ouvriers[(voleur->numero + k) % nbOuvriers];
+        uint64_t plage = atomic_load(&victime->plage);
+        for (;;) {
+            uint32_t debut = (uint32_t)(plage >> 32);
+            uint32_t fin = (uint32_t)plage;
+            if (debut >= fin) {
+                break;
+            }
+            uint32_t moitie = (fin - debut + 1) / 2;
+            if (atomic_compare_exchange_weak(&victime->plage, &plage,
+                    ((uint64_t)debut << 32) | (fin - moitie))) {
+                atomic_store(&voleur->plage, ((uint64_t)(fin - moitie) << 32) | fin);
+                voleur->vols++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Ne garde d'un script que les touches de direction.
+ *
+ * Comme chargerScript dans programme.c : un autre caractère serait joué
+ * comme une direction et fausserait la répartition des issues.
+ * @param brut Script donné par -s.
+ * @return Le script filtré (alloué), ou NULL s'il ne reste aucune direction.
+ */
+char *filtrerScript(const char *brut) {
+    char *filtre = malloc(strlen(brut) + 1);
+    size_t longueur = 0;
+
+    if (filtre == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    for (const char *c = brut; *c != '\0'; c++) {
+        if (*c == DROITE || *c == GAUCHE || *c == HAUT || *c == BAS) {
+            filtre[longueur++] = *c;
+        }
+    }
+    filtre[longueur] = '\0';
+    if (longueur == 0) {
+        free(filtre);
+        return NULL;
+    }
+    return filtre;
+}
+
+/**
+ * @brief Horloge monotone en secondes.
+ * @return Le temps écoulé depuis une origine fixe, en secondes.
+ */
+double maintenant() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
@@ -0,0 +1,686 @@
+/**
+ * @file snake.c
+ * @brief Règles du jeu snake, sans entrée/sortie (bibliothèque libsnake).
+ *
+ * Voir snake.h pour la construction de la bibliothèque.
+ *
+ * @author 
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "snake.h"
+
+/*****************************************************
+*                CONSTANTES DU JEU                   *
+*****************************************************/
+
+const int COORDMIN = 1; /** Coordonnée minimale utilisée sur le plateau. */
+const int TAILLESERPENT = 10; /** Taille initiale du serpent. */
+const int NBREPAVE = 4; /** Nombre de pavés d'obstacles à placer. */
+const int TAILLEPAVE = 5; /** Taille d'un pavé d'obstacle. */
+const int TEMPORISATION = 200000; /** Temps de pause entre deux déplacements */
+const int NBREPOMMESFINJEU = 10; /** Nombre de pommes à manger pour gagner. */
+const int MARGESECURITE = 3; /** Écart minimal entre un pavé et le serpent au départ. */
+const int MAXESSAISPAVE = 1000; /** Tirages au-delà desquels un pavé est abandonné. */
+const int AUGMENTATIONVITESSE = 15000; /** augmentation de la vitesse */
+const char TETE = 'O'; /** Caractère représentant la tête du serpent. */
+const char CORPS = 'X'; /** Caractère représentant le corps du serpent. */
+const char POMME = '6'; /** Caractère représentant une pomme. */
+const char ARRET = 'a'; /** Caractère permettant d'arrêter le jeu. */
+const char DROITE = 'd'; /** Direction : droite. */
+const char GAUCHE = 'q'; /** Direction : gauche. */
+const char HAUT = 'z'; /** Direction : haut. */
+const char BAS = 's'; /** Direction : bas. */
+const char VIDE = ' '; /** Caractère représentant une case vide. */
+const char CARBORDURE = '#'; /** Caractère représentant une bordure ou un obstacle. */
+const char ISSUE = '+'; /** Valeur des cases d'issue de la bordure (affichées vides). */
+
+/*****************************************************
+*               NOYAU DE DEPLACEMENT                 *
+*****************************************************/
+
+/** Force l'expansion en ligne des fonctions du noyau, pour que chaque
+ * instanciation profite de dimensions constantes. */
+#if defined(__GNUC__)
+#define ENLIGNE static inline __attribute__((always_inline))
+#else
+#define ENLIGNE static inline
+#endif
+
+/* Les fonctions du noyau qui dépendent des dimensions du plateau les reçoivent
+ * en paramètres.
+ * Appelées avec des constantes (progresserDefaut), le compilateur en tire
+ * une version où le pas des lignes, les coordonnées des issues et les
+ * tests de bordure sont repliés ; appelées avec les champs du plateau
+ * (progresser), elles forment le chemin générique.
+ */
+
+/**
+ * @brief Modifie une case du plateau en tenant à jour l'ensemble des cases libres.
+ *
+ * rangLibre vaut -2 hors de l'intérieur du plateau : une case intérieure
+ * qui se vide est reconnue sans repasser par ses coordonnées. La case est
+ * ajoutée à la liste des cases modifiées destinée à l'afficheur.
+ * @param etat État de la partie.
+ * @param indice Indice de la case (y * pas + x).
+ * @param c Nouveau contenu de la case.
+ */
+ENLIGNE void ecrireIndice(EtatJeu *etat, int indice, char c) {
+    int rang = etat->rangLibre[indice];
+    if (rang >= 0 && c != VIDE) {
+        /** retrait : la dernière case libre prend la place de celle-ci */
+        int derniere = etat->casesLibres[--etat->nbCasesLibres];
+        etat->casesLibres[rang] = derniere;
+        etat->rangLibre[derniere] = rang;
+        etat->rangLibre[indice] = -1;
+    } else if (rang == -1 && c == VIDE) {
+        etat->rangLibre[indice] = etat->nbCasesLibres;
+        etat->casesLibres[etat->nbCasesLibres++] = indice;
+    }
+    etat->plateau.origine[indice] = c;
+
+    CasesModifiees *modifiees = &etat->modifiees;
+    if (modifiees->nb < CAPACITEMODIFIEES) {
+        modifiees->cases[modifiees->nb++] = indice;
+    } else {
+        modifiees->debordement = true;
+    }
+}
+
+/**
+ * @brief Calcule la case atteinte depuis une case en un pas dans une direction.
+ *
+ * Tient compte des issues : le serpent qui en emprunte une réapparaît
+ * du côté opposé du plateau. Grâce à l'anneau de garde, la case voisine
+ * est toujours lisible : seule une case ISSUE demande un second calcul.
+ * @param origine Case (0, 0) du plateau.
+ * @param indice Indice de la case de départ (y * pas + x).
+ * @param direction Direction du déplacement.
+ * @param largeur Largeur du plateau.
+ * @param hauteur Hauteur du plateau.
+ * @param pas Pas des lignes du plateau.
+ * @return L'indice de la case atteinte.
+ */
+ENLIGNE int caseSuivanteNoyau(const char *origine, int indice, char direction,
+                              int largeur, int hauteur, int pas) {
+    /** change l'indice de la case en fonction de la direction */
+    if (direction == DROITE) indice++;
+    if (direction == GAUCHE) indice--;
+    if (direction == HAUT) indice -= pas;
+    if (direction == BAS) indice += pas;
+
+    /** gestion de la réapparition du seprent lorsqu'il emprunte une issue */
+    if (origine[indice] == ISSUE) {
+        int X = indice % pas;
+        int Y = indice / pas;
+        if (X == 0) X = largeur - 2;
+        else if (X == largeur - 1) X = 1;
+        else if (Y == 0) Y = hauteur - 2;
+        else Y = 1;
+        indice = Y * pas + X;
+    }
+    return indice;
+}
+
+/**
+ * @brief Fait progresser le serpent d'une étape.
+ *
+ * Le coût est constant quelle que soit la taille du serpent : la nouvelle
+ * tête est écrite devant l'ancienne dans le tampon circulaire et seule la
+ * queue est effacée du plateau. Si une pomme est mangée, la queue est
+ * conservée et le serpent grandit d'un anneau ; le tampon n'est agrandi
+ * qu'à ce moment-là, et seulement s'il est plein.
+ * @param etat État de la partie.
+ * @param direction Direction actuelle du serpent ; un autre caractère garde celle du pas précédent.
+ * @param collision Indique si une collision a été détectée.
+ * @param pommeMangee Indique si une pomme a été mangée.
+ * @param largeur Largeur du plateau.
+ * @param hauteur Hauteur du plateau.
+ * @param pas Pas des lignes du plateau.
+ * @return false si la mémoire a manqué pour agrandir le serpent (rien n'est alors modifié).
+ */
+ENLIGNE bool progresserNoyau(EtatJeu *etat, char direction, bool *collision, bool *pommeMangee,
+                             int largeur, int hauteur, int pas) {
+    Serpent *serpent = &etat->serpent;
+    char *origine = etat->plateau.origine;
+    int tete = serpent->anneaux[serpent->tete];
+
+    /** une touche qui n'est pas une direction garde la direction courante :
+     * sinon la tête resterait sur place et le serpent serait figé */
+    if (direction != DROITE && direction != GAUCHE && direction != HAUT && direction != BAS) {
+        direction = serpent->direction;
+    }
+    int suivante = caseSuivanteNoyau(origine, tete, direction, largeur, hauteur, pas);
+
+    *pommeMangee = (suivante == etat->posY_pomme * pas + etat->posX_pomme);
+    if (*pommeMangee) {
+        /** la queue reste en place : le serpent grandit */
+        if (serpent->taille == serpent->capacite && !agrandirSerpent(serpent)) {
+            return false;
+        }
+        serpent->taille++;
+    } else {
+        /** effacer le dernier segment du seprent
+         * pour monter qu'il avance
+         */
+        int queue = (serpent->tete + serpent->taille - 1) & (serpent->capacite - 1);
+        ecrireIndice(etat, serpent->anneaux[queue], VIDE);
+    }
+
+    /** Gestion des collisions avec le plateau, les pavés et le corps du serpent */
+    char contenu = origine[suivante];
+    *collision = contenu == CARBORDURE || contenu == CORPS;
+
+    /** l'ancienne tête devient un anneau du corps, la nouvelle tête
+     * prend la case précédant l'ancienne dans le tampon circulaire
+     */
+    ecrireIndice(etat, tete, CORPS);
+    serpent->tete = (serpent->tete - 1) & (serpent->capacite - 1);
+    serpent->anneaux[serpent->tete] = suivante;
+    ecrireIndice(etat, suivante, TETE);
+    serpent->direction = direction;
+    return true;
+}
+
+/**
+ * @brief Noyau spécialisé pour le plateau par défaut (80x40), à dimensions constantes.
+ * @param etat État de la partie, de taille LARGEURDEFAUT x HAUTEURDEFAUT.
+ * @param direction Direction actuelle du serpent.
+ * @param collision Indique si une collision a été détectée.
+ * @param pommeMangee Indique si une pomme a été mangée.
+ * @return false si la mémoire a manqué pour agrandir le serpent.
+ */
+static bool progresserDefaut(EtatJeu *etat, char direction, bool *collision, bool *pommeMangee) {
+    return progresserNoyau(etat, direction, collision, pommeMangee,
+        LARGEURDEFAUT, HAUTEURDEFAUT, LARGEURDEFAUT + 2);
+}
+
+/*****************************************************
+*               FONCTIONS/PROCEDURES                *
+*****************************************************/
+
+/**
+ * @brief Alloue l'état d'une partie sur un plateau de la taille voulue.
+ *
+ * Le plateau, son anneau de garde, l'ensemble des cases libres et le
+ * tampon du serpent sont alloués une fois pour toutes (le tampon du
+ * serpent grandit ensuite au besoin) ; l'état peut ensuite servir à autant de
+ * parties que voulu (initEtatJeu).
+ * @param largeur Nombre de colonnes, bordure comprise (TAILLEMIN à TAILLEMAX).
+ * @param hauteur Nombre de lignes, bordure comprise (TAILLEMIN à TAILLEMAX).
+ * @return L'état alloué, ou NULL si la taille est invalide ou la mémoire insuffisante.
+ */
+EtatJeu *creerEtatJeu(int largeur, int hauteur) {
+    if (largeur < TAILLEMIN || largeur > TAILLEMAX || hauteur < TAILLEMIN || hauteur > TAILLEMAX) {
+        return NULL;
+    }
+    EtatJeu *etat = calloc(1, sizeof(EtatJeu));
+    if (etat == NULL) {
+        return NULL;
+    }
+    Plateau *plateau = &etat->plateau;
+    plateau->largeur = largeur;
+    plateau->hauteur = hauteur;
+    plateau->pas = largeur + 2;
+    plateau->cases = malloc((size_t)(hauteur + 2) * plateau->pas);
+    etat->rangLibre = malloc((size_t)hauteur * plateau->pas * sizeof(int));
+    etat->casesLibres = malloc((size_t)(largeur - 2) * (hauteur - 2) * sizeof(int));
+    etat->serpent.capacite = CAPACITESERPENT;
+    etat->serpent.anneaux = malloc(CAPACITESERPENT * sizeof(int));
+    if (plateau->cases == NULL || etat->rangLibre == NULL || etat->casesLibres == NULL ||
+        etat->serpent.anneaux == NULL) {
+        detruireEtatJeu(etat);
+        return NULL;
+    }
+    plateau->origine = plateau->cases + plateau->pas + 1;
+    etat->noyauSpecialise = (largeur == LARGEURDEFAUT && hauteur == HAUTEURDEFAUT);
+    return etat;
+}
+
+/**
+ * @brief Libère un état créé par creerEtatJeu.
+ * @param etat État à libérer (NULL accepté).
+ */
+void detruireEtatJeu(EtatJeu *etat) {
+    if (etat == NULL) {
+        return;
+    }
+    free(etat->plateau.cases);
+    free(etat->rangLibre);
+    free(etat->casesLibres);
+    free(etat->serpent.anneaux);
+    free(etat);
+}
+
+/**
+ * @brief Prépare une nouvelle partie : plateau, pavés, serpent et première pomme.
+ * @param etat État de la partie à initialiser, créé par creerEtatJeu.
+ * @param graineInitiale Graine du générateur aléatoire de la partie.
+ * @param flux Numéro de flux du générateur, distinct pour chaque partie simultanée.
+ */
+void initEtatJeu(EtatJeu *etat, uint64_t graineInitiale, uint64_t flux) {
+    initGenerateur(&etat->generateur, graineInitiale, flux);
+    etat->temporisation = TEMPORISATION;
+    etat->pommesMangees = 0;
+    etat->posX_pomme = -1;
+    etat->posY_pomme = -1;
+    initPlateau(etat);
+    placerPaves(etat);
+    initSerpent(etat);
+    ajouterPomme(etat);
+}
+
+/**
+ * @brief Fait avancer une partie d'un pas.
+ *
+ * Déplace le serpent puis applique les conséquences d'une pomme mangée :
+ * accélération, croissance (gérée par progresser) et nouvelle pomme.
+ * Si la mémoire manque pour agrandir le serpent, le pas n'est pas joué
+ * et memoireEpuisee est levé : la partie ne peut continuer.
+ * @param etat État de la partie.
+ * @param direction Direction du serpent pour ce pas ; un autre caractère garde la direction courante.
+ * @return Les événements survenus pendant ce pas.
+ */
+ResultatPas avancer(EtatJeu *etat, char direction) {
+    ResultatPas resultat = {false, false, false, false};
+    bool joue;
+
+    /** le plateau par défaut passe par le noyau à dimensions constantes */
+    if (etat->noyauSpecialise) {
+        joue = progresserDefaut(etat, direction, &resultat.collision, &resultat.pommeMangee);
+    } else {
+        joue = progresser(etat, direction, &resultat.collision, &resultat.pommeMangee);
+    }
+    if (!joue) {
+        resultat.memoireEpuisee = true;
+        return resultat;
+    }
+    // gestion des modification lorqu'une pomme est mangée
+    if (resultat.pommeMangee) {
+        etat->pommesMangees++;
+        etat->temporisation = etat->temporisation - AUGMENTATIONVITESSE;
+        ajouterPomme(etat);
+    }
+    resultat.victoire = etat->pommesMangees >= NBREPOMMESFINJEU;
+    return resultat;
+}
+
+/**
+ * @brief Initialise le plateau avec les bordures et les issues.
+ * @param etat État de la partie.
+ */
+void initPlateau(EtatJeu *etat) {
+    Plateau *plateau = &etat->plateau;
+    int largeur = plateau->largeur;
+    int hauteur = plateau->hauteur;
+
+    /** l'anneau de garde, hors du plateau, est un mur */
+    memset(plateau->cases, CARBORDURE, (size_t)(hauteur + 2) * plateau->pas);
+    /** Double boucle for permettant de se déplacer sur la bordure du tableau 
+     * en largeur et en hauteur et afficher la bordure 
+     * sauf si le curseur est au milieu de la bordure
+     */
+    for (int i = 0; i < hauteur; i++) {
+        char *ligne = plateau->origine + i * plateau->pas;
+        for (int j = 0; j < largeur; j++) {
+            if (i == 0 || i == hauteur - 1) {
+                ligne[j] = (j == largeur / 2) ? ISSUE : CARBORDURE;
+            } else if (j == 0 || j == largeur - 1) {
+                ligne[j] = (i == hauteur / 2) ? ISSUE : CARBORDURE;
+            } else {
+                ligne[j] = VIDE;
+            }
+        }
+    }
+    /** tout le plateau a changé : l'afficheur doit tout comparer */
+    etat->modifiees.nb = 0;
+    etat->modifiees.debordement = true;
+    /** toutes les cases intérieures sont libres au départ */
+    etat->nbCasesLibres = 0;
+    for (int i = 0; i < hauteur; i++) {
+        for (int j = 0; j < plateau->pas; j++) {
+            int indice = i * plateau->pas + j;
+            if (i > 0 && i < hauteur - 1 && j > 0 && j < largeur - 1) {
+                etat->rangLibre[indice] = etat->nbCasesLibres;
+                etat->casesLibres[etat->nbCasesLibres++] = indice;
+            } else {
+                etat->rangLibre[indice] = -2;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Place une pomme sur une case vide aléatoire.
+ *
+ * La case est tirée directement dans l'ensemble des cases libres : un seul
+ * tirage suffit, quel que soit le remplissage du plateau.
+ */
+void ajouterPomme(EtatJeu *etat) {
+    if (etat->nbCasesLibres == 0) {
+        /** plateau rempli par le serpent : plus de pomme */
+        etat->posX_pomme = -1;
+        etat->posY_pomme = -1;
+        return;
+    }
+    /** tire une case parmi les cases libres */
+    int indice = etat->casesLibres[tirerBorne(&etat->generateur, etat->nbCasesLibres)];
+    etat->posX_pomme = indice % etat->plateau.pas;
+    etat->posY_pomme = indice / etat->plateau.pas;
+    ecrireCase(etat, etat->posX_pomme, etat->posY_pomme, POMME);
+}
+
+/**
+ * @brief Modifie une case du plateau en tenant à jour l'ensemble des cases libres.
+ * @param etat État de la partie.
+ * @param x Coordonnée en X.
+ * @param y Coordonnée en Y.
+ * @param c Nouveau contenu de la case.
+ */
+void ecrireCase(EtatJeu *etat, int x, int y, char c) {
+    ecrireIndice(etat, y * etat->plateau.pas + x, c);
+}
+
+/**
+ * @brief Lit le contenu d'une case du plateau.
+ * @param etat État de la partie.
+ * @param x Coordonnée en X (de -1 à largeur : l'anneau de garde est lisible).
+ * @param y Coordonnée en Y (de -1 à hauteur).
+ * @return Le contenu de la case.
+ */
+char lireCase(const EtatJeu *etat, int x, int y) {
+    return etat->plateau.origine[y * etat->plateau.pas + x];
+}
+
+/**
+ * @brief Donne accès à une ligne du plateau, pour l'afficher d'un bloc.
+ * @param etat État de la partie.
+ * @param y Numéro de la ligne.
+ * @return Les largeur cases de la ligne, contiguës.
+ */
+const char *lignePlateau(const EtatJeu *etat, int y) {
+    return etat->plateau.origine + y * etat->plateau.pas;
+}
+
+/**
+ * @brief Vide la liste des cases modifiées, une fois l'affichage à jour.
+ * @param etat État de la partie.
+ */
+void viderModifications(EtatJeu *etat) {
+    etat->modifiees.nb = 0;
+    etat->modifiees.debordement = false;
+}
+
+/**
+ * @brief Taille de départ du serpent, réduite si le plateau est trop étroit.
+ * @param plateau Plateau de la partie.
+ * @return Le nombre d'anneaux du serpent au départ.
+ */
+static int tailleDepart(const Plateau *plateau) {
+    int tailleMax = plateau->largeur / 2 - 1;
+    return (TAILLESERPENT < tailleMax) ? TAILLESERPENT : tailleMax;
+}
+
+/**
+ * @brief Place des pavés d'obstacles sur le plateau 
+ * en dehors de la zone de sécurité.
+ *
+ * La zone de sécurité entoure le serpent de départ, au centre du plateau.
+ * Sur les plus petits plateaux, où aucune position tirée ne peut sortir de
+ * cette zone, aucun pavé n'est posé. Ailleurs, un pavé qui ne trouve pas
+ * de place après MAXESSAISPAVE tirages n'est pas posé.
+ * @param etat État de la partie.
+ */
+void placerPaves(EtatJeu *etat) {
+    const Plateau *plateau = &etat->plateau;
+    int departX = plateau->largeur / 2;
+    int departY = plateau->hauteur / 2;
+    int debutZoneX = departX - tailleDepart(plateau) - TAILLEPAVE - MARGESECURITE;
+    int finZoneX = departX + MARGESECURITE;
+    int debutZoneY = departY - TAILLEPAVE - MARGESECURITE;
+    int finZoneY = departY + MARGESECURITE;
+    /** les pavés sont tirés en x dans [2, largeur - 9], en y dans [2, hauteur - 9] */
+    int maxX = plateau->largeur - 9;
+    int maxY = plateau->hauteur - 9;
+
+    if (maxX < 2 || maxY < 2) {
+        return;
+    }
+    if (2 > debutZoneX && maxX < finZoneX && 2 > debutZoneY && maxY < finZoneY) {
+        /** toutes les positions possibles sont dans la zone de sécurité */
+        return;
+    }
+
+    for (int k = 0; k < NBREPAVE; k++) {
+        int x, y;
+        int essais = 0;
+        bool dansZone;
+        do {
+            /** génère aléatoirement une coordonnée X */
+            x = tirerBorne(&etat->generateur, plateau->largeur - 10) + 2; 
+            /** génère aléatoirement une coordonnées Y */
+            y = tirerBorne(&etat->generateur, plateau->hauteur - 10) + 2;
+            dansZone = x > debutZoneX && x < finZoneX && y > debutZoneY && y < finZoneY;
+        } while (dansZone && ++essais < MAXESSAISPAVE);
+        if (dansZone) {
+            continue;
+        }
+        /** place le pavé si les coordonnées sont valide */
+        for (int i = 0; i < TAILLEPAVE; i++) {
+            for (int j = 0; j < TAILLEPAVE; j++) {
+                ecrireCase(etat, x + j, y + i, CARBORDURE);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Place le serpent à sa position de départ et l'inscrit sur le plateau.
+ *
+ * La tête part du centre du plateau, le corps s'étendant vers la gauche.
+ * @param etat État de la partie.
+ */
+void initSerpent(EtatJeu *etat) {
+    Serpent *serpent = &etat->serpent;
+    serpent->tete = 0;
+    serpent->direction = DROITE;
+    serpent->taille = tailleDepart(&etat->plateau);
+    for (int i = 0; i < serpent->taille; i++) {
+        int x = etat->plateau.largeur / 2 - i;
+        int y = etat->plateau.hauteur / 2;
+        serpent->anneaux[i] = y * etat->plateau.pas + x;
+        ecrireCase(etat, x, y, (i == 0) ? TETE : CORPS);
+    }
+}
+
+/**
+ * @brief Indice de case du i-ème anneau du serpent (0 = tête).
+ * @param serpent Serpent parcouru.
+ * @param i Rang de l'anneau, entre 0 et taille - 1.
+ * @return L'indice (y * pas + x) de la case de l'anneau.
+ */
+int serpentCase(const Serpent *serpent, int i) {
+    return serpent->anneaux[(serpent->tete + i) & (serpent->capacite - 1)];
+}
+
+/**
+ * @brief Coordonnée X du i-ème anneau du serpent (0 = tête).
+ * @param etat État de la partie.
+ * @param i Rang de l'anneau, entre 0 et taille - 1.
+ * @return La coordonnée X de l'anneau.
+ */
+int serpentX(const EtatJeu *etat, int i) {
+    return serpentCase(&etat->serpent, i) % etat->plateau.pas;
+}
+
+/**
+ * @brief Coordonnée Y du i-ème anneau du serpent (0 = tête).
+ * @param etat État de la partie.
+ * @param i Rang de l'anneau, entre 0 et taille - 1.
+ * @return La coordonnée Y de l'anneau.
+ */
+int serpentY(const EtatJeu *etat, int i) {
+    return serpentCase(&etat->serpent, i) / etat->plateau.pas;
+}
+
+/**
+ * @brief Double la capacité du tampon circulaire du serpent.
+ *
+ * Les anneaux situés entre la tête et la fin de l'ancien tampon sont
+ * décalés à la fin du nouveau : l'ordre circulaire est conservé.
+ * Appelée uniquement quand une pomme est mangée avec un tampon plein.
+ * @param serpent Serpent à agrandir.
+ * @return false si la mémoire manque (le serpent est alors inchangé).
+ */
+bool agrandirSerpent(Serpent *serpent) {
+    int ancienne = serpent->capacite;
+    int *anneaux = realloc(serpent->anneaux, (size_t)ancienne * 2 * sizeof(int));
+    if (anneaux == NULL) {
+        return false;
+    }
+    memmove(anneaux + serpent->tete + ancienne, anneaux + serpent->tete,
+        (size_t)(ancienne - serpent->tete) * sizeof(int));
+    serpent->anneaux = anneaux;
+    serpent->tete += ancienne;
+    serpent->capacite = ancienne * 2;
+    return true;
+}
+
+/**
+ * @brief Fait progresser le serpent d'une étape (chemin générique, toutes tailles).
+ * @param etat État de la partie.
+ * @param direction Direction actuelle du serpent ; un autre caractère garde celle du pas précédent.
+ * @param collision Indique si une collision a été détectée.
+ * @param pommeMangee Indique si une pomme a été mangée.
+ * @return false si la mémoire a manqué pour agrandir le serpent.
+ */
+bool progresser(EtatJeu *etat, char direction, bool *collision, bool *pommeMangee) {
+    const Plateau *plateau = &etat->plateau;
+    return progresserNoyau(etat, direction, collision, pommeMangee,
+        plateau->largeur, plateau->hauteur, plateau->pas);
+}
+
+/**
+ * @brief Calcule la case atteinte depuis (x, y) en un pas dans une direction.
+ *
+ * Tient compte des issues (voir caseSuivanteNoyau).
+ * @param etat État de la partie.
+ * @param x Coordonnée en X, remplacée par celle de la case suivante.
+ * @param y Coordonnée en Y, remplacée par celle de la case suivante.
+ * @param direction Direction du déplacement.
+ */
+void positionSuivante(const EtatJeu *etat, int *x, int *y, char direction) {
+    const Plateau *plateau = &etat->plateau;
+    int indice = caseSuivanteNoyau(plateau->origine, *y * plateau->pas + *x, direction,
+        plateau->largeur, plateau->hauteur, plateau->pas);
+    *x = indice % plateau->pas;
+    *y = indice / plateau->pas;
+}
+
+/**
+ * @brief Donne la direction opposée à une direction.
+ * @param direction Direction de départ.
+ * @return La direction inverse (demi-tour).
+ */
+char directionOpposee(char direction) {
+    if (direction == DROITE) return GAUCHE;
+    if (direction == GAUCHE) return DROITE;
+    if (direction == HAUT) return BAS;
+    return HAUT;
+}
+
+/*****************************************************
+*           POLITIQUES DE JEU AUTOMATIQUE            *
+*****************************************************/
+
+/**
+ * @brief Politique aléatoire : tire une des trois directions sans demi-tour.
+ * @param g Générateur propre au joueur automatique.
+ * @param direction Direction actuelle du serpent.
+ * @return La direction choisie.
+ */
+char directionAleatoire(Generateur *g, char direction) {
+    const char directions[4] = {HAUT, DROITE, BAS, GAUCHE};
+    char choix;
+    do {
+        choix = directions[tirerBorne(g, 4)];
+    } while (choix == directionOpposee(direction));
+    return choix;
+}
+
+/**
+ * @brief Politique gloutonne : se rapproche de la pomme sans heurter d'obstacle.
+ *
+ * Parmi les directions sans demi-tour menant à une case ni bordure ni corps,
+ * choisit celle qui minimise la distance à la pomme. Si toutes sont bloquées,
+ * la direction actuelle est conservée.
+ * @param etat État de la partie.
+ * @param direction Direction actuelle du serpent.
+ * @return La direction choisie.
+ */
+char directionGlouton(const EtatJeu *etat, char direction) {
+    const char directions[4] = {HAUT, DROITE, BAS, GAUCHE};
+    char choix = direction;
+    int meilleure = -1;
+
+    for (int k = 0; k < 4; k++) {
+        if (directions[k] == directionOpposee(direction)) continue;
+        int x = serpentX(etat, 0);
+        int y = serpentY(etat, 0);
+        positionSuivante(etat, &x, &y, directions[k]);
+        char contenu = lireCase(etat, x, y);
+        if (contenu == CARBORDURE || contenu == CORPS) continue;
+        int distance = abs(x - etat->posX_pomme) + abs(y - etat->posY_pomme);
+        if (meilleure < 0 || distance < meilleure) {
+            meilleure = distance;
+            choix = directions[k];
+        }
+    }
+    return choix;
+}
+
+/*****************************************************
+*             GENERATEUR PSEUDO-ALEATOIRE            *
+*****************************************************/
+
+/**
+ * @brief Sème un générateur PCG32.
+ * @param g Générateur à initialiser.
+ * @param graineInitiale Graine de la partie.
+ * @param flux Numéro de flux, pour obtenir des suites indépendantes.
+ */
+void initGenerateur(Generateur *g, uint64_t graineInitiale, uint64_t flux) {
+    g->etat = 0;
+    g->increment = (flux << 1) | 1;
+    tirer(g);
+    g->etat += graineInitiale;
+    tirer(g);
+}
+
+/**
+ * @brief Tire un entier pseudo-aléatoire sur 32 bits.
+ * @param g Générateur utilisé.
+ * @return Un entier uniformément réparti sur 32 bits.
+ */
+uint32_t tirer(Generateur *g) {
+    uint64_t ancien = g->etat;
+    g->etat = ancien * 6364136223846793005ULL + g->increment;
+    uint32_t melange = (uint32_t)(((ancien >> 18) ^ ancien) >> 27);
+    uint32_t rotation = (uint32_t)(ancien >> 59);
+    return (melange >> rotation) | (melange << ((-rotation) & 31));
+}
+
+/**
+ * @brief Tire un entier dans [0, borne[ par multiplication, sans division.
+ * @param g Générateur utilisé.
+ * @param borne Borne supérieure exclue (strictement positive).
+ * @return Un entier entre 0 et borne - 1.
+ */
+uint32_t tirerBorne(Generateur *g, uint32_t borne) {
+    return (uint32_t)(((uint64_t)tirer(g) * borne) >> 32);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file snake.h
+ * @brief Règles du jeu snake, sans entrée/sortie (bibliothèque libsnake).
+ *
+ * Cette bibliothèque contient l'état d'une partie et les règles du jeu :
+ * initialisation du plateau, pavés, pommes et déplacement du serpent.
+ * Elle n'utilise ni stdio ni termios ni temporisation : un client
+ * (le jeu en terminal programme.c, un simulateur...) fait avancer une
+ * partie avec avancer() et affiche le résultat comme il l'entend.
+ *
+ * @details
+ * Construction de la bibliothèque et du jeu :
+ * - statique : gcc -O2 -c snake.c && ar rcs libsnake.a snake.o
+ * - partagée : gcc -O2 -fPIC -shared snake.c -o libsnake.so
+ * - jeu : gcc -O2 programme.c difference.c -L. -lsnake -o programme
+ *
+ * La taille du plateau se choisit à l'exécution, à la création de la
+ * partie (creerEtatJeu), entre TAILLEMIN et TAILLEMAX cases de côté.
+ *
+ * @author 
+ * Arthur CHAUVEL
+ *
+ * @version 4.0
+ */
+
+#ifndef SNAKE_H
+#define SNAKE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * @defgroup Constante du jeu
+ * 
+ */
+/** Largeur du plateau de jeu par défaut. */
+#define LARGEURDEFAUT 80
+/** Hauteur du plateau de jeu par défaut. */
+#define HAUTEURDEFAUT 40
+/** Plus petit côté de plateau accepté. */
+#define TAILLEMIN 10
+/** Plus grand côté de plateau accepté. */
+#define TAILLEMAX 4096
+/** Capacité initiale du tampon du serpent (puissance de 2). */
+#define CAPACITESERPENT 16
+/** Écritures de cases retenues entre deux affichages (environ 3 par pas). */
+#define CAPACITEMODIFIEES 256
+
+extern const int TEMPORISATION; /** Temps de pause entre deux déplacements */
+extern const int NBREPOMMESFINJEU; /** Nombre de pommes à manger pour gagner. */
+extern const int AUGMENTATIONVITESSE; /** augmentation de la vitesse */
+extern const char TETE; /** Caractère représentant la tête du serpent. */
+extern const char CORPS; /** Caractère représentant le corps du serpent. */
+extern const char POMME; /** Caractère représentant une pomme. */
+extern const char ARRET; /** Caractère permettant d'arrêter le jeu. */
+extern const char DROITE; /** Direction : droite. */
+extern const char GAUCHE; /** Direction : gauche. */
+extern const char HAUT; /** Direction : haut. */
+extern const char BAS; /** Direction : bas. */
+extern const char VIDE; /** Caractère représentant une case vide. */
+extern const char CARBORDURE; /** Caractère représentant une bordure ou un obstacle. */
+extern const char ISSUE; /** Valeur des cases d'issue de la bordure (affichées vides). */
+
+/** @brief Corps du serpent stocké dans un tampon circulaire.
+ *
+ * Chaque anneau est codé par l'indice de sa case sur le plateau
+ * (y * pas + x), un seul entier au lieu de deux coordonnées.
+ * L'anneau i (0 = tête) se trouve à l'indice (tete + i) modulo capacite :
+ * avancer ne coûte qu'une écriture et grandir ne coûte rien, l'ancienne
+ * queue restant en place dans le tampon. La capacité double quand une
+ * pomme est mangée avec un tampon plein, jamais pendant un pas ordinaire :
+ * le serpent peut remplir tout le plateau.
+ */
+typedef struct {
+    int *anneaux; /** Indices de case des anneaux. */
+    int capacite; /** Taille du tampon, puissance de 2. */
+    int tete; /** Indice de la tête dans le tampon. */
+    int taille; /** Nombre d'anneaux, tête comprise. */
+    char direction; /** Direction du dernier pas, gardée si un pas reçoit une touche qui n'en est pas une. */
+} Serpent;
+
+/** @brief Générateur pseudo-aléatoire PCG32 propre à une partie.
+ *
+ * Semé une seule fois au démarrage ; deux flux différents donnent des
+ * suites indépendantes pour une même graine.
+ */
+typedef struct {
+    uint64_t etat; /** État interne. */
+    uint64_t increment; /** Sélecteur de flux (toujours impair). */
+} Generateur;
+
+/** @brief Plateau de jeu alloué à l'exécution.
+ *
+ * Les cases sont rangées ligne par ligne : la case (x, y) se trouve à
+ * origine[y * pas + x]. Le plateau est entouré d'un anneau de garde d'une
+ * case rempli de CARBORDURE, si bien que les voisines de n'importe quelle
+ * case du plateau, bordure comprise, sont toujours lisibles. Les issues de
+ * la bordure valent ISSUE : seul ce cas rare demande un traitement
+ * particulier lors d'un déplacement.
+ */
+typedef struct {
+    int largeur; /** Nombre de colonnes, bordure comprise. */
+    int hauteur; /** Nombre de lignes, bordure comprise. */
+    int pas; /** Écart entre deux lignes consécutives (largeur + 2). */
+    char *cases; /** Zone allouée, anneau de garde compris. */
+    char *origine; /** Case (0, 0) du plateau dans cases. */
+} Plateau;
+
+/** @brief Cases du plateau écrites depuis le dernier affichage.
+ *
+ * Toute écriture de case (progresser, ajouterPomme, placerPaves...) y ajoute
+ * l'indice de la case : un afficheur peut ne redessiner que ces cases, pour
+ * un coût proportionnel au nombre de changements et non à la taille du
+ * plateau. Au-delà de CAPACITEMODIFIEES écritures, ou quand tout le plateau
+ * est réinitialisé (initPlateau), la liste est déclarée débordée et
+ * l'afficheur doit comparer tout le plateau. L'afficheur vide la liste
+ * (viderModifications) après chaque trame.
+ */
+typedef struct {
+    int cases[CAPACITEMODIFIEES]; /** Indices (y * pas + x) des cases écrites, doublons possibles. */
+    int nb; /** Nombre d'indices retenus. */
+    bool debordement; /** La liste est incomplète : tout comparer. */
+} CasesModifiees;
+
+/** @brief État complet d'une partie (GameState).
+ *
+ * Toutes les données modifiables d'une partie y sont regroupées et passées
+ * explicitement aux fonctions du jeu : plusieurs parties indépendantes
+ * peuvent ainsi coexister dans un même processus, y compris sur plusieurs
+ * threads.
+ */
+typedef struct {
+    Plateau plateau; /** Plateau de jeu. */
+    /** Ensemble des cases intérieures vides, où une pomme peut apparaître.
+     * casesLibres contient les indices (y * pas + x) des cases libres
+     * de façon contiguë ; rangLibre donne pour chaque case son rang dans
+     * casesLibres, -1 si c'est une case intérieure occupée, -2 hors de
+     * l'intérieur du plateau.
+     */
+    int *casesLibres;
+    int *rangLibre;
+    int nbCasesLibres;
+    Serpent serpent; /** Corps du serpent. */
+    Generateur generateur; /** Générateur aléatoire de la partie. */
+    int temporisation; /** Temps de pause courant entre deux déplacements. */
+    int posX_pomme; /** Coordonnée X de la pomme. */
+    int posY_pomme; /** Coordonnée Y de la pomme. */
+    int pommesMangees; /** Nombre de pommes mangées depuis le début. */
+    /** avancer utilise le noyau compilé pour 80x40 ; choisi par creerEtatJeu
+     * selon la taille du plateau, peut être remis à false pour comparer
+     * avec le chemin générique. */
+    bool noyauSpecialise;
+    CasesModifiees modifiees; /** Cases écrites depuis le dernier affichage. */
+} EtatJeu;
+
+/** @brief Résultat d'un pas de jeu renvoyé par avancer. */
+typedef struct {
+    bool collision; /** Le serpent a heurté une bordure, un pavé ou son corps. */
+    bool pommeMangee; /** Le serpent a mangé une pomme pendant ce pas. */
+    bool victoire; /** Le nombre de pommes nécessaire pour gagner est atteint. */
+    bool memoireEpuisee; /** Le serpent n'a pu grandir faute de mémoire ; le pas n'est pas joué. */
+} ResultatPas;
+
+/** Déclaration des fonctions */
+EtatJeu *creerEtatJeu(int largeur, int hauteur);
+void detruireEtatJeu(EtatJeu *etat);
+void initEtatJeu(EtatJeu *etat, uint64_t graineInitiale, uint64_t flux);
+ResultatPas avancer(EtatJeu *etat, char direction);
+void initPlateau(EtatJeu *etat);
+void placerPaves(EtatJeu *etat);
+void initSerpent(EtatJeu *etat);
+void ajouterPomme(EtatJeu *etat);
+void ecrireCase(EtatJeu *etat, int x, int y, char c);
+char lireCase(const EtatJeu *etat, int x, int y);
+const char *lignePlateau(const EtatJeu *etat, int y);
+void viderModifications(EtatJeu *etat);
+int serpentCase(const Serpent *serpent, int i);
+int serpentX(const EtatJeu *etat, int i);
+int serpentY(const EtatJeu *etat, int i);
+bool agrandirSerpent(Serpent *serpent);
+bool progresser(EtatJeu *etat, char direction, bool *collision, bool *pommeMangee);
+void positionSuivante(const EtatJeu *etat, int *x, int *y, char direction);
+char directionOpposee(char direction);
+char directionAleatoire(Generateur *g, char direction);
+char directionGlouton(const EtatJeu *etat, char direction);
+void initGenerateur(Generateur *g, uint64_t graineInitiale, uint64_t flux);
+uint32_t tirer(Generateur *g);
+uint32_t tirerBorne(Generateur *g, uint32_t borne);
+
+#endif
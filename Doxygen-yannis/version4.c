@@ -28,6 +28,7 @@
 #include <termios.h>
 #include <stdbool.h>
 #include <time.h>
+#include <stdint.h>
 
 /*
  * @defgroup Constante du jeu
@@ -43,6 +44,8 @@
 #define TAILLE_MAX_SERPENT (TAILLE_SERPENT + OBJECTIF_POMMES)   /**< Définition du tableau plateau */
 #define LARGEUR_PLATEAU 80  /**< Largeur maximale du plateau. */ 
 #define HAUTEUR_PLATEAU 40  /**< Longueur maximale du plateau. */   
+#define BITS_PAR_MOT 64     /**< Nombre de cases codées par mot de la carte d'occupation. */
+#define NB_MOTS_OCCUPATION ((LARGEUR_PLATEAU * HAUTEUR_PLATEAU + BITS_PAR_MOT - 1) / BITS_PAR_MOT) /**< 3200 cases : 50 mots. */
 
 /** Définitions des constantes */
 const char COTE_BORDURE = '#';          /**< Caractère utilisé pour afficher les bordures et pavés. */
@@ -70,6 +73,13 @@ int taille_serpent;
 typedef char plateauGlobale[HAUTEUR_PLATEAU][LARGEUR_PLATEAU];
 plateauGlobale plateauJeu;
 
+/** @typedef Occupation_du_plateau
+* @brief Carte d'occupation du plateau : un bit par case, à 1 si la case 
+* contient une bordure, un pavé ou un anneau du serpent.
+*/
+typedef uint64_t occupationPlateau[NB_MOTS_OCCUPATION];
+occupationPlateau occupation;
+
 /* Déclaration des fonctions */
 void afficher(int x, int y, char c);
 void effacer(int x, int y);
@@ -79,6 +89,9 @@ void initPlateau(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU]);
 void dessinerPlateau(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU]);
 void placerPaves(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU]);
 void ajouterPomme(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU]);
+void occuper(int x, int y);
+void liberer(int x, int y);
+bool estOccupee(int x, int y);
 void gotoXY(int x, int y);
 int kbhit();
 void disableEcho();
@@ -119,9 +132,14 @@ int main()
     
     initPlateau(plateauJeu);
     placerPaves(plateauJeu);
+    for (int i = 0; i < taille_serpent; i++)
+    {
+        occuper(lesX[i], lesY[i]);
+    }
     ajouterPomme(plateauJeu);
     dessinerPlateau(plateauJeu);
     dessinerSerpent(lesX, lesY);
+    fflush(stdout);
 
     while (condition_arret == TRUE) {
         if (kbhit() == TRUE)
@@ -177,6 +195,8 @@ int main()
             condition_arret = FALSE;
         }  
         
+        // Un seul vidage de la sortie par déplacement
+        fflush(stdout);
         usleep(vitesse_actuelle);
     }
 
@@ -196,7 +216,6 @@ void afficher(int x, int y, char c)
 {
     gotoXY(x, y);
     printf("%c", c);
-    fflush(stdout);
 }
 
 /**
@@ -241,6 +260,8 @@ void dessinerSerpent(int lesX[], int lesY[])
  *
  * Gère les déplacements, détecte les collisions (obstacles, corps), et 
  * vérifie si une pomme a été mangée. Met à jour la position du plateau en conséquence.
+ * Les collisions se résument à un test dans la carte d'occupation, tenue à jour
+ * quand la tête entre dans une case et quand la queue en sort.
  *
  * @param lesX Tableau contenant les coordonnées X des segments du serpent.
  * @param lesY Tableau contenant les coordonnées Y des segments du serpent.
@@ -252,6 +273,8 @@ void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *p
 {
     *collision = false;
     *pomme_mangee = false;
+    int queue_x = lesX[taille_serpent - 1];
+    int queue_y = lesY[taille_serpent - 1];
 
     // Mise à jour des positions du corps
     for (int i = taille_serpent - 1; i > 0; i--) 
@@ -283,22 +306,19 @@ void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *p
     if (lesY[0] < 0) lesY[0] = HAUTEUR_PLATEAU - 1;
     if (lesY[0] >= HAUTEUR_PLATEAU) lesY[0] = 0;
 
-    // Collisions avec le corps
-    for (int i = 1; i < taille_serpent; i++) 
+    // La queue libère sa case, sauf si l'anneau ajouté par la dernière pomme l'occupe encore
+    if (lesX[taille_serpent - 1] != queue_x || lesY[taille_serpent - 1] != queue_y)
     {
-        if (lesX[0] == lesX[i] && lesY[0] == lesY[i]) 
-        {
-            *collision = true;
-            return;
-        }
+        liberer(queue_x, queue_y);
     }
 
-    // Collisions avec les obstacles
-    if (plateauJeu[lesY[0]][lesX[0]] == COTE_BORDURE) 
+    // Collisions avec le corps et les obstacles
+    if (estOccupee(lesX[0], lesY[0])) 
     {
         *collision = true;
         return;
     }
+    occuper(lesX[0], lesY[0]);
 
     // Gestion des pommes
     if (plateauJeu[lesY[0]][lesX[0]] == POMME)
@@ -330,10 +350,12 @@ void initPlateau(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU])
             if (i == 0 || i == HAUTEUR_PLATEAU - 1 || j == 0 || j == LARGEUR_PLATEAU - 1) 
             {
                 plateau[i][j] = COTE_BORDURE;
+                occuper(j, i);
             } 
             else 
             {
                 plateau[i][j] = VIDE;
+                liberer(j, i);
             }
         }
     }
@@ -342,6 +364,10 @@ void initPlateau(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU])
     plateau[HAUTEUR_PLATEAU-1][LARGEUR_PLATEAU/2] = VIDE;
     plateau[HAUTEUR_PLATEAU/2][0] = VIDE;
     plateau[HAUTEUR_PLATEAU/2][LARGEUR_PLATEAU-1] = VIDE;
+    liberer(LARGEUR_PLATEAU/2, 0);
+    liberer(LARGEUR_PLATEAU/2, HAUTEUR_PLATEAU-1);
+    liberer(0, HAUTEUR_PLATEAU/2);
+    liberer(LARGEUR_PLATEAU-1, HAUTEUR_PLATEAU/2);
 }
 
 /**
@@ -391,6 +417,7 @@ void placerPaves(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU])
             for (int j = 0; j < TAILLE_PAVE; j++) 
             {
                 plateau[y + i][x + j] = COTE_BORDURE;
+                occuper(x + j, y + i);
             }
         }
     }
@@ -399,7 +426,8 @@ void placerPaves(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU])
 /**
  * @brief Ajoute une pomme à une position aléatoire sur le plateau.
  *
- * La pomme est placée uniquement sur une case vide.
+ * La pomme est placée uniquement sur une case vide : ni obstacle ni serpent
+ * d'après la carte d'occupation, et pas déjà une pomme.
  *
  * @param plateau Tableau 2D représentant le plateau.
  */
@@ -409,12 +437,49 @@ void ajouterPomme(char plateau[HAUTEUR_PLATEAU][LARGEUR_PLATEAU])
     do {
         x = rand() % (LARGEUR_PLATEAU - 2) + 1;
         y = rand() % (HAUTEUR_PLATEAU - 2) + 1;
-    } while (plateau[y][x] != VIDE);
+    } while (estOccupee(x, y) || plateau[y][x] == POMME);
     
     plateau[y][x] = POMME;
     afficher(x, y, POMME);
 }
 
+/**
+ * @brief Marque une case comme occupée dans la carte d'occupation.
+ *
+ * @param x Coordonnée en X (colonne).
+ * @param y Coordonnée en Y (ligne).
+ */
+void occuper(int x, int y)
+{
+    int indice = y * LARGEUR_PLATEAU + x;
+    occupation[indice / BITS_PAR_MOT] |= (uint64_t)1 << (indice % BITS_PAR_MOT);
+}
+
+/**
+ * @brief Marque une case comme libre dans la carte d'occupation.
+ *
+ * @param x Coordonnée en X (colonne).
+ * @param y Coordonnée en Y (ligne).
+ */
+void liberer(int x, int y)
+{
+    int indice = y * LARGEUR_PLATEAU + x;
+    occupation[indice / BITS_PAR_MOT] &= ~((uint64_t)1 << (indice % BITS_PAR_MOT));
+}
+
+/**
+ * @brief Indique si une case est occupée (bordure, pavé ou serpent).
+ *
+ * @param x Coordonnée en X (colonne).
+ * @param y Coordonnée en Y (ligne).
+ * @return true si la case est occupée, false sinon.
+ */
+bool estOccupee(int x, int y)
+{
+    int indice = y * LARGEUR_PLATEAU + x;
+    return (occupation[indice / BITS_PAR_MOT] >> (indice % BITS_PAR_MOT)) & 1;
+}
+
 /** 
 * Fonctions et procédures donner  
 */